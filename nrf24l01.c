@@ -49,6 +49,13 @@
 #define NRF24L01_CS_ACTIVE 				0
 #define NRF24L01_CS_UNACTIVE 			1
 
+/**
+ * @brief   Number of STATUS reads between two 1 ms delays while waiting on TX
+ * 			FIFO. One packet takes less than 1 ms on air, so the FIFO is
+ * 			refilled without waiting for the next tick.
+ */
+#define NRF24L01_TX_POLL_SPIN_CNT 		32
+
 
 typedef struct nrf24l01 {
 	uint16_t  					channel; 			/*!< Channel */
@@ -56,7 +63,7 @@ typedef struct nrf24l01 {
 	uint8_t  					crc_len; 			/*!< CRC length */
 	uint8_t  					addr_width; 		/*!< Address width */
 	uint8_t  					retrans_cnt; 		/*!< Re-transmit count */
-	uint8_t  					retrans_delay; 		/*!< Re-transmit delay */
+	uint16_t  					retrans_delay; 		/*!< Re-transmit delay */
 	nrf24l01_data_rate_t 		data_rate;			/*!< Data rate */
 	nrf24l01_output_pwr_t 		output_pwr;			/*!< Output power */
 	nrf24l01_transceiver_mode_t transceiver_mode;	/*!< Mode operation */
@@ -66,17 +73,59 @@ typedef struct nrf24l01 {
 	nrf24l01_func_set_gpio 		set_ce;				/*!< Function set chip enable pin */
 	nrf24l01_func_get_gpio 		get_irq;			/*!< Function get irq pin */
 	nrf24l01_func_delay			delay; 				/*!< Function delay */
+	nrf24l01_bus_handle_t 		bus;				/*!< Shared SPI bus */
+	nrf24l01_func_bus_acquire 	bus_acquire;		/*!< Function lock shared bus */
+	nrf24l01_func_bus_release 	bus_release;		/*!< Function unlock shared bus */
+	uint8_t 					batch;				/*!< Bus is held across transactions */
+	uint32_t 					xfer_len;			/*!< Bytes transferred while bus is held */
+	uint8_t 					reg_config;			/*!< Last value written to CONFIG register */
 } nrf24l01_t;
 
+static void nrf24l01_spi_begin(nrf24l01_handle_t handle)
+{
+	/* Bus is locked per transaction unless a batch already holds it */
+	if ((handle->bus_acquire != NULL) && !handle->batch)
+	{
+		handle->bus_acquire(handle->bus);
+		handle->xfer_len = 0;
+	}
+
+	handle->set_cs(NRF24L01_CS_ACTIVE);
+}
+
+static void nrf24l01_spi_end(nrf24l01_handle_t handle)
+{
+	handle->set_cs(NRF24L01_CS_UNACTIVE);
+
+	if ((handle->bus_acquire != NULL) && !handle->batch)
+	{
+		handle->bus_release(handle->bus, handle->xfer_len);
+	}
+}
+
+static err_code_t nrf24l01_spi_send(nrf24l01_handle_t handle, uint8_t *buf_send, uint16_t len)
+{
+	handle->xfer_len += len;
+
+	return handle->spi_send(buf_send, len);
+}
+
+static err_code_t nrf24l01_spi_recv(nrf24l01_handle_t handle, uint8_t *buf_recv, uint16_t len)
+{
+	handle->xfer_len += len;
+
+	return handle->spi_recv(buf_recv, len);
+}
+
 static uint8_t nrf24l01_read_register(nrf24l01_handle_t handle, uint8_t reg)
 {
 	uint8_t command = NRF24L01P_CMD_R_REGISTER | reg;
 	uint8_t read_val;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->spi_recv(&read_val, 1);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_recv(handle, &read_val, 1);
+	nrf24l01_spi_end(handle);
 
 	return read_val;
 }
@@ -86,10 +135,27 @@ static err_code_t nrf24l01_write_register(nrf24l01_handle_t handle, uint8_t reg,
 	uint8_t command = NRF24L01P_CMD_W_REGISTER | reg;
 	uint8_t write_val = value;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->spi_send(&write_val, 1);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	if (reg == NRF24L01P_REG_CONFIG)
+	{
+		handle->reg_config = value;
+	}
+
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_send(handle, &write_val, 1);
+	nrf24l01_spi_end(handle);
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t nrf24l01_write_register_multi(nrf24l01_handle_t handle, uint8_t reg, uint8_t *value, uint8_t len)
+{
+	uint8_t command = NRF24L01P_CMD_W_REGISTER | reg;
+
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_send(handle, value, len);
+	nrf24l01_spi_end(handle);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -98,10 +164,10 @@ static err_code_t nrf24l01_read_rx_fifo(nrf24l01_handle_t handle, uint8_t* rx_pa
 {
 	uint8_t command = NRF24L01P_CMD_R_RX_PAYLOAD;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->spi_recv(rx_payload, handle->packet_len);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_recv(handle, rx_payload, handle->packet_len);
+	nrf24l01_spi_end(handle);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -110,10 +176,65 @@ static err_code_t nrf24l01_write_tx_fifo(nrf24l01_handle_t handle, uint8_t* tx_p
 {
 	uint8_t command = NRF24L01P_CMD_W_TX_PAYLOAD;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->spi_send(tx_payload, handle->packet_len);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_send(handle, tx_payload, handle->packet_len);
+	nrf24l01_spi_end(handle);
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t nrf24l01_write_tx_fifo_noack(nrf24l01_handle_t handle, uint8_t* tx_payload)
+{
+	uint8_t command = NRF24L01P_CMD_W_TX_PAYLOAD_NOACK;
+
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_send(handle, tx_payload, handle->packet_len);
+	nrf24l01_spi_end(handle);
+
+	return ERR_CODE_SUCCESS;
+}
+
+static err_code_t nrf24l01_wait_tx_fifo_free(nrf24l01_handle_t handle, uint32_t timeout_ms)
+{
+	uint8_t status;
+	uint8_t spin_cnt = 0;
+
+	while (1)
+	{
+		nrf24l01_get_status(handle, &status);
+		if (status & NRF24L01_STATUS_MAX_RT)
+		{
+			nrf24l01_flush_tx_fifo(handle);
+			nrf24l01_clear_max_rt(handle);
+
+			return ERR_CODE_FAIL;
+		}
+
+		if (!(status & NRF24L01_STATUS_TX_FULL))
+		{
+			break;
+		}
+
+		if (++spin_cnt < NRF24L01_TX_POLL_SPIN_CNT)
+		{
+			continue;
+		}
+		spin_cnt = 0;
+
+		if (timeout_ms-- == 0)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		handle->delay(1);
+	}
+
+	if (status & NRF24L01_STATUS_TX_DS)
+	{
+		nrf24l01_clear_tx_ds(handle);
+	}
 
 	return ERR_CODE_SUCCESS;
 }
@@ -152,8 +273,8 @@ static void nrf24l01_auto_retransmit_count(nrf24l01_handle_t handle, uint8_t cnt
 	uint8_t setup_retr = nrf24l01_read_register(handle, NRF24L01P_REG_SETUP_RETR);
 
 	/* Reset ARC register 0 */
-	setup_retr |= 0xF0;
-	setup_retr |= cnt;
+	setup_retr &= 0xF0;
+	setup_retr |= cnt & 0x0F;
 
 	nrf24l01_write_register(handle, NRF24L01P_REG_SETUP_RETR, setup_retr);
 }
@@ -163,8 +284,11 @@ static void nrf24l01_auto_retransmit_delay(nrf24l01_handle_t handle, uint16_t us
 	uint8_t setup_retr = nrf24l01_read_register(handle, NRF24L01P_REG_SETUP_RETR);
 
 	/* Reset ARD register 0 */
-	setup_retr |= 0x0F;
-	setup_retr |= ((us / 250) - 1) << 4;
+	setup_retr &= 0x0F;
+	if (us >= 250)
+	{
+		setup_retr |= (((us / 250) - 1) & 0x0F) << 4;
+	}
 
 	nrf24l01_write_register(handle, NRF24L01P_REG_SETUP_RETR, setup_retr);
 }
@@ -252,6 +376,16 @@ err_code_t nrf24l01_set_config(nrf24l01_handle_t handle, nrf24l01_cfg_t config)
 	handle->set_ce = config.set_ce;
 	handle->get_irq = config.get_irq;
 	handle->delay = config.delay;
+	handle->bus = config.bus;
+	handle->bus_acquire = config.bus_acquire;
+	handle->bus_release = config.bus_release;
+
+	/* Both bus functions or none */
+	if ((handle->bus_acquire == NULL) || (handle->bus_release == NULL))
+	{
+		handle->bus_acquire = NULL;
+		handle->bus_release = NULL;
+	}
 
 	return ERR_CODE_SUCCESS;
 }
@@ -285,7 +419,9 @@ err_code_t nrf24l01_config(nrf24l01_handle_t handle)
 	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P5, 0x00);
 	nrf24l01_write_register(handle, NRF24L01P_REG_FIFO_STATUS, 0x11);
 	nrf24l01_write_register(handle, NRF24L01P_REG_DYNPD, 0x00);
-	nrf24l01_write_register(handle, NRF24L01P_REG_FEATURE, 0x00);
+
+	/* Enable W_TX_PAYLOAD_NOACK command */
+	nrf24l01_write_register(handle, NRF24L01P_REG_FEATURE, 0x01);
 
 	/* Reset FIFO */
 	nrf24l01_flush_rx_fifo(handle);
@@ -476,9 +612,9 @@ err_code_t nrf24l01_flush_rx_fifo(nrf24l01_handle_t handle)
 
 	uint8_t command = NRF24L01P_CMD_FLUSH_RX;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_end(handle);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -493,9 +629,9 @@ err_code_t nrf24l01_flush_tx_fifo(nrf24l01_handle_t handle)
 
 	uint8_t command = NRF24L01P_CMD_FLUSH_TX;
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_send(&command, 1);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_send(handle, &command, 1);
+	nrf24l01_spi_end(handle);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -540,9 +676,9 @@ err_code_t nrf24l01_get_status(nrf24l01_handle_t handle, uint8_t *status)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	handle->set_cs(NRF24L01_CS_ACTIVE);
-	handle->spi_recv(status, 1);
-	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	nrf24l01_spi_begin(handle);
+	nrf24l01_spi_recv(handle, status, 1);
+	nrf24l01_spi_end(handle);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -568,11 +704,8 @@ err_code_t nrf24l01_clear_tx_ds(nrf24l01_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
-	uint8_t status;
-	nrf24l01_get_status(handle, &status);
-	status |= 0x20;
-
-	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, status);
+	/* Write 1 to TX_DS only, other flags are left untouched */
+	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, NRF24L01_STATUS_TX_DS);
 
 	return ERR_CODE_SUCCESS;
 }
@@ -585,16 +718,268 @@ err_code_t nrf24l01_clear_max_rt(nrf24l01_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
+	/* Write 1 to MAX_RT only, other flags are left untouched */
+	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, NRF24L01_STATUS_MAX_RT);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_clear_rx_dr(nrf24l01_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Write 1 to RX_DR only, other flags are left untouched */
+	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, NRF24L01_STATUS_RX_DR);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_get_config(nrf24l01_handle_t handle, nrf24l01_cfg_t *config)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (config == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	config->channel = handle->channel;
+	config->packet_len = handle->packet_len;
+	config->crc_len = handle->crc_len;
+	config->addr_width = handle->addr_width;
+	config->retrans_cnt = handle->retrans_cnt;
+	config->retrans_delay = handle->retrans_delay;
+	config->data_rate = handle->data_rate;
+	config->output_pwr = handle->output_pwr;
+	config->transceiver_mode = handle->transceiver_mode;
+	config->spi_send = handle->spi_send;
+	config->spi_recv = handle->spi_recv;
+	config->set_cs = handle->set_cs;
+	config->set_ce = handle->set_ce;
+	config->get_irq = handle->get_irq;
+	config->delay = handle->delay;
+	config->bus = handle->bus;
+	config->bus_acquire = handle->bus_acquire;
+	config->bus_release = handle->bus_release;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_data_rate(nrf24l01_handle_t handle, nrf24l01_data_rate_t data_rate)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	nrf24l01_set_rf_air_data_rate(handle, data_rate);
+	handle->data_rate = data_rate;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_output_power(nrf24l01_handle_t handle, nrf24l01_output_pwr_t output_pwr)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	nrf24l01_set_rf_tx_output_power(handle, output_pwr);
+	handle->output_pwr = output_pwr;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_auto_retransmit(nrf24l01_handle_t handle, uint8_t retrans_cnt, uint16_t retrans_delay)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((retrans_cnt > 15) || (retrans_delay < 250) || (retrans_delay > 4000))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* ARD in upper nibble, ARC in lower nibble */
+	uint8_t setup_retr = (((retrans_delay / 250) - 1) << 4) | retrans_cnt;
+	nrf24l01_write_register(handle, NRF24L01P_REG_SETUP_RETR, setup_retr);
+
+	handle->retrans_cnt = retrans_cnt;
+	handle->retrans_delay = retrans_delay;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_get_observe_tx(nrf24l01_handle_t handle, uint8_t *plos_cnt, uint8_t *arc_cnt)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t observe_tx = nrf24l01_read_register(handle, NRF24L01P_REG_OBSERVE_TX);
+
+	if (plos_cnt != NULL)
+	{
+		*plos_cnt = observe_tx >> 4;
+	}
+
+	if (arc_cnt != NULL)
+	{
+		*arc_cnt = observe_tx & 0x0F;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_clear_plos_cnt(nrf24l01_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	nrf24l01_set_rf_channel(handle, handle->channel);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_transmit_pipelined(nrf24l01_handle_t handle, uint8_t* tx_payload, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->delay == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret = nrf24l01_wait_tx_fifo_free(handle, timeout_ms);
+	if (err_ret != ERR_CODE_SUCCESS)
+	{
+		return err_ret;
+	}
+
+	nrf24l01_write_tx_fifo(handle, tx_payload);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_transmit_noack_pipelined(nrf24l01_handle_t handle, uint8_t* tx_payload, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->delay == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret = nrf24l01_wait_tx_fifo_free(handle, timeout_ms);
+	if (err_ret != ERR_CODE_SUCCESS)
+	{
+		return err_ret;
+	}
+
+	nrf24l01_write_tx_fifo_noack(handle, tx_payload);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_wait_tx_complete(nrf24l01_handle_t handle, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->delay == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
 	uint8_t status;
-	nrf24l01_get_status(handle, &status);
-	status |= 0x10;
+	uint8_t fifo_status;
+	uint8_t spin_cnt = 0;
 
-	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, status);
+	while (1)
+	{
+		nrf24l01_get_status(handle, &status);
+		if (status & NRF24L01_STATUS_MAX_RT)
+		{
+			nrf24l01_flush_tx_fifo(handle);
+			nrf24l01_clear_max_rt(handle);
+
+			return ERR_CODE_FAIL;
+		}
+
+		fifo_status = nrf24l01_read_register(handle, NRF24L01P_REG_FIFO_STATUS);
+		if (fifo_status & NRF24L01_FIFO_STATUS_TX_EMPTY)
+		{
+			break;
+		}
+
+		if (++spin_cnt < NRF24L01_TX_POLL_SPIN_CNT)
+		{
+			continue;
+		}
+		spin_cnt = 0;
+
+		if (timeout_ms-- == 0)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		handle->delay(1);
+	}
+
+	if (status & NRF24L01_STATUS_TX_DS)
+	{
+		nrf24l01_clear_tx_ds(handle);
+	}
 
 	return ERR_CODE_SUCCESS;
 }
 
-err_code_t nrf24l01_clear_rx_dr(nrf24l01_handle_t handle)
+err_code_t nrf24l01_try_receive(nrf24l01_handle_t handle, uint8_t* rx_payload)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t fifo_status = nrf24l01_read_register(handle, NRF24L01P_REG_FIFO_STATUS);
+	if (fifo_status & NRF24L01_FIFO_STATUS_RX_EMPTY)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_read_rx_fifo(handle, rx_payload);
+	nrf24l01_clear_rx_dr(handle);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_transceiver_mode(nrf24l01_handle_t handle, nrf24l01_transceiver_mode_t transceiver_mode)
 {
 	/* Check if handle structure is NULL */
 	if (handle == NULL)
@@ -602,11 +987,239 @@ err_code_t nrf24l01_clear_rx_dr(nrf24l01_handle_t handle)
 		return ERR_CODE_NULL_PTR;
 	}
 
+	handle->set_ce(0);
+
+	uint8_t reg_config_data = nrf24l01_read_register(handle, NRF24L01P_REG_CONFIG);
+	if (transceiver_mode == NRF24L01_TRANSCEIVER_MODE_TX)
+	{
+		reg_config_data &= 0xFE;
+	}
+	else
+	{
+		reg_config_data |= 1 << 0;
+		nrf24l01_rx_set_payload_widths(handle, handle->packet_len);
+	}
+	nrf24l01_write_register(handle, NRF24L01P_REG_CONFIG, reg_config_data);
+
+	handle->transceiver_mode = transceiver_mode;
+
+	handle->set_ce(1);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_begin_batch(nrf24l01_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->batch)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (handle->bus_acquire != NULL)
+	{
+		handle->bus_acquire(handle->bus);
+	}
+
+	handle->xfer_len = 0;
+	handle->batch = 1;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_end_batch(nrf24l01_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (!handle->batch)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->batch = 0;
+
+	if (handle->bus_acquire != NULL)
+	{
+		handle->bus_release(handle->bus, handle->xfer_len);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_get_rpd(nrf24l01_handle_t handle, uint8_t *rpd)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (rpd == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*rpd = nrf24l01_read_register(handle, NRF24L01P_REG_RPD) & 0x01;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_tx_address(nrf24l01_handle_t handle, uint8_t *addr)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (addr == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	nrf24l01_write_register_multi(handle, NRF24L01P_REG_TX_ADDR, addr, handle->addr_width);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_rx_address(nrf24l01_handle_t handle, uint8_t pipe, uint8_t *addr)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (addr == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (pipe > 5)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (pipe < 2)
+	{
+		nrf24l01_write_register_multi(handle, NRF24L01P_REG_RX_ADDR_P0 + pipe, addr, handle->addr_width);
+	}
+	else
+	{
+		nrf24l01_write_register(handle, NRF24L01P_REG_RX_ADDR_P0 + pipe, addr[0]);
+	}
+
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P0 + pipe, handle->packet_len);
+
+	uint8_t en_rxaddr = nrf24l01_read_register(handle, NRF24L01P_REG_EN_RXADDR);
+	nrf24l01_write_register(handle, NRF24L01P_REG_EN_RXADDR, en_rxaddr | (1 << pipe));
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_config_image(nrf24l01_handle_t handle, const nrf24l01_reg_image_t *image)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (image == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->set_cs(NRF24L01_CS_UNACTIVE);
+	handle->set_ce(0);
+
+	nrf24l01_write_register(handle, NRF24L01P_REG_CONFIG, image->config);
+	nrf24l01_write_register(handle, NRF24L01P_REG_EN_AA, image->en_aa);
+	nrf24l01_write_register(handle, NRF24L01P_REG_EN_RXADDR, image->en_rxaddr);
+	nrf24l01_write_register(handle, NRF24L01P_REG_SETUP_AW, image->setup_aw);
+	nrf24l01_write_register(handle, NRF24L01P_REG_SETUP_RETR, image->setup_retr);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RF_CH, image->rf_ch);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RF_SETUP, image->rf_setup);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P0, image->rx_pw_p0);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P1, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P2, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P3, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P4, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_RX_PW_P5, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_DYNPD, 0x00);
+	nrf24l01_write_register(handle, NRF24L01P_REG_FEATURE, image->feature);
+	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, 0x70);
+
+	/* Reset FIFO */
+	nrf24l01_flush_rx_fifo(handle);
+	nrf24l01_flush_tx_fifo(handle);
+
+	handle->set_ce(1);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_get_tx_done(nrf24l01_handle_t handle, uint8_t in_fifo, uint8_t *num_done)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (num_done == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
 	uint8_t status;
+
+	*num_done = 0;
+
 	nrf24l01_get_status(handle, &status);
 
-	status |= 0x40;
-	nrf24l01_write_register(handle, NRF24L01P_REG_STATUS, status);
+	if (status & NRF24L01_STATUS_MAX_RT)
+	{
+		nrf24l01_flush_tx_fifo(handle);
+		nrf24l01_clear_max_rt(handle);
+
+		return ERR_CODE_FAIL;
+	}
+
+	if (status & NRF24L01_STATUS_TX_DS)
+	{
+		nrf24l01_clear_tx_ds(handle);
+
+		uint8_t fifo_status = nrf24l01_read_register(handle, NRF24L01P_REG_FIFO_STATUS);
+		if (fifo_status & NRF24L01_FIFO_STATUS_TX_EMPTY)
+		{
+			*num_done = in_fifo;
+		}
+		else if (in_fifo != 0)
+		{
+			*num_done = 1;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_set_prim_rx(nrf24l01_handle_t handle, uint8_t prim_rx)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t reg_config_data = prim_rx ? (handle->reg_config | 0x01) : (handle->reg_config & 0xFE);
+
+	handle->set_ce(0);
+	nrf24l01_write_register(handle, NRF24L01P_REG_CONFIG, reg_config_data);
+	handle->set_ce(1);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_disable_rx_pipe(nrf24l01_handle_t handle, uint8_t pipe)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (pipe > 5)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t en_rxaddr = nrf24l01_read_register(handle, NRF24L01P_REG_EN_RXADDR);
+	nrf24l01_write_register(handle, NRF24L01P_REG_EN_RXADDR, en_rxaddr & ~(1 << pipe));
 
 	return ERR_CODE_SUCCESS;
 }
@@ -32,17 +32,48 @@ extern "C" {
 #define NRF24L01_IRQ_ACTIVE_LEVEL 		0
 #define NRF24L01_IRQ_UNACTIVE_LEVEL 	1
 
+/**
+ * @brief   STATUS register bits.
+ */
+#define NRF24L01_STATUS_RX_DR 			0x40
+#define NRF24L01_STATUS_TX_DS 			0x20
+#define NRF24L01_STATUS_MAX_RT 			0x10
+#define NRF24L01_STATUS_TX_FULL 		0x01
+
+/**
+ * @brief   FIFO_STATUS register bits.
+ */
+#define NRF24L01_FIFO_STATUS_TX_FULL 	0x20
+#define NRF24L01_FIFO_STATUS_TX_EMPTY 	0x10
+#define NRF24L01_FIFO_STATUS_RX_FULL 	0x02
+#define NRF24L01_FIFO_STATUS_RX_EMPTY 	0x01
+
+/**
+ * @brief   Number of payloads TX FIFO holds.
+ */
+#define NRF24L01_TX_FIFO_DEPTH 			3
+
 typedef err_code_t (*nrf24l01_func_spi_send)(uint8_t *buf_send, uint16_t len);
 typedef err_code_t (*nrf24l01_func_spi_recv)(uint8_t *buf_recv, uint16_t len);
 typedef err_code_t (*nrf24l01_func_set_gpio)(uint8_t level);
 typedef err_code_t (*nrf24l01_func_get_gpio)(uint8_t *level);
 typedef void (*nrf24l01_func_delay)(uint32_t time_ms);
+typedef uint32_t (*nrf24l01_func_get_tick)(void);
+typedef uint32_t (*nrf24l01_func_get_time_us)(void);
 
 /**
  * @brief   NRF24L01 handle structure.
  */
 typedef struct nrf24l01* nrf24l01_handle_t;
 
+/**
+ * @brief   Shared SPI bus handle structure, see "nrf24l01_bus.h".
+ */
+typedef struct nrf24l01_bus* nrf24l01_bus_handle_t;
+
+typedef err_code_t (*nrf24l01_func_bus_acquire)(nrf24l01_bus_handle_t bus);
+typedef err_code_t (*nrf24l01_func_bus_release)(nrf24l01_bus_handle_t bus, uint32_t num_byte);
+
 /**
  * @brief   Data rate.
  */
@@ -79,7 +110,7 @@ typedef struct {
 	uint8_t  					crc_len; 			/*!< CRC length */
 	uint8_t  					addr_width; 		/*!< Address width */
 	uint8_t  					retrans_cnt; 		/*!< Re-transmit count */
-	uint8_t  					retrans_delay; 		/*!< Re-transmit delay */
+	uint16_t  					retrans_delay; 		/*!< Re-transmit delay in us, multiple of 250 */
 	nrf24l01_data_rate_t 		data_rate;			/*!< Data rate */
 	nrf24l01_output_pwr_t 		output_pwr;			/*!< Output power */
 	nrf24l01_transceiver_mode_t transceiver_mode;	/*!< Mode operation */
@@ -89,8 +120,26 @@ typedef struct {
 	nrf24l01_func_set_gpio 		set_ce;				/*!< Function set chip enable pin */
 	nrf24l01_func_get_gpio 		get_irq;			/*!< Function get irq pin */
 	nrf24l01_func_delay			delay; 				/*!< Function delay */
+	nrf24l01_bus_handle_t 		bus;				/*!< Shared SPI bus, NULL if SPI is not shared */
+	nrf24l01_func_bus_acquire 	bus_acquire;		/*!< Function lock shared bus, e.g. "nrf24l01_bus_acquire", optional */
+	nrf24l01_func_bus_release 	bus_release;		/*!< Function unlock shared bus, e.g. "nrf24l01_bus_release", optional */
 } nrf24l01_cfg_t;
 
+/**
+ * @brief   Register image. Values written as is by "nrf24l01_config_image".
+ */
+typedef struct {
+	uint8_t 					config;				/*!< CONFIG register */
+	uint8_t 					en_aa;				/*!< EN_AA register */
+	uint8_t 					en_rxaddr;			/*!< EN_RXADDR register */
+	uint8_t 					setup_aw;			/*!< SETUP_AW register */
+	uint8_t 					setup_retr;			/*!< SETUP_RETR register */
+	uint8_t 					rf_ch;				/*!< RF_CH register */
+	uint8_t 					rf_setup;			/*!< RF_SETUP register */
+	uint8_t 					rx_pw_p0;			/*!< RX_PW_P0 register */
+	uint8_t 					feature;			/*!< FEATURE register */
+} nrf24l01_reg_image_t;
+
 /*
  * @brief   Initialize nRF24L01 with default parameters.
  *
@@ -352,6 +401,308 @@ err_code_t nrf24l01_clear_max_rt(nrf24l01_handle_t handle);
  */
 err_code_t nrf24l01_clear_rx_dr(nrf24l01_handle_t handle);
 
+/*
+ * @brief   Get configuration parameters currently applied to the handle.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_get_config(nrf24l01_handle_t handle, nrf24l01_cfg_t *config);
+
+/*
+ * @brief   Change air data rate at runtime.
+ *
+ * @param 	handle Handle structure.
+ * @param 	data_rate Data rate.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_data_rate(nrf24l01_handle_t handle, nrf24l01_data_rate_t data_rate);
+
+/*
+ * @brief   Change output power at runtime.
+ *
+ * @param 	handle Handle structure.
+ * @param 	output_pwr Output power.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_output_power(nrf24l01_handle_t handle, nrf24l01_output_pwr_t output_pwr);
+
+/*
+ * @brief   Change auto retransmit count and delay at runtime.
+ *
+ * @note 	This function write both ARC and ARD fields in the SETUP_RETR register.
+ *
+ * @param 	handle Handle structure.
+ * @param 	retrans_cnt Re-transmit count, 0 to 15.
+ * @param 	retrans_delay Re-transmit delay in us, 250 to 4000 in step of 250.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_auto_retransmit(nrf24l01_handle_t handle, uint8_t retrans_cnt, uint16_t retrans_delay);
+
+/*
+ * @brief   Get data on OBSERVE_TX register.
+ *
+ * @note 	PLOS_CNT counts packets which did not get through after maximum number
+ * 			of retransmits. It saturates at 15 and is reset by writing RF_CH, see
+ * 			"nrf24l01_clear_plos_cnt". ARC_CNT counts retransmitted packets of the
+ * 			last payload and is reset when transmission of a new packet starts.
+ *
+ * @param 	handle Handle structure.
+ * @param 	plos_cnt Count lost packets.
+ * @param 	arc_cnt Count retransmitted packets.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_get_observe_tx(nrf24l01_handle_t handle, uint8_t *plos_cnt, uint8_t *arc_cnt);
+
+/*
+ * @brief   Reset lost packets counter PLOS_CNT in the OBSERVE_TX register.
+ *
+ * @note 	This function write current channel to the RF_CH register.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_clear_plos_cnt(nrf24l01_handle_t handle);
+
+/*
+ * @brief   Write data to TX FIFO as soon as a location is available. Up to 3
+ * 			payloads are queued in TX FIFO so that the radio transmits them back
+ * 			to back. TX_DS flag is cleared when asserted.
+ *
+ * @note 	Function "delay" need to be assigned. If MAX_RT is asserted, TX FIFO
+ * 			is flushed, MAX_RT is cleared and this function fails.
+ *
+ * @param 	handle Handle structure.
+ * @param 	tx_payload Transmit buffer.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_transmit_pipelined(nrf24l01_handle_t handle, uint8_t* tx_payload, uint32_t timeout_ms);
+
+/*
+ * @brief   Polling until TX FIFO is empty or timeout. Used after the last call
+ * 			of "nrf24l01_transmit_pipelined".
+ *
+ * @note 	Function "delay" need to be assigned. If MAX_RT is asserted, TX FIFO
+ * 			is flushed, MAX_RT is cleared and this function fails.
+ *
+ * @param 	handle Handle structure.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_wait_tx_complete(nrf24l01_handle_t handle, uint32_t timeout_ms);
+
+/*
+ * @brief   Same as "nrf24l01_transmit_pipelined" but the payload is sent without
+ * 			requesting an ACK, so the radio never retransmits it.
+ *
+ * @note 	Function "delay" need to be assigned. The NOACK command is enabled by
+ * 			"nrf24l01_config" through the EN_DYN_ACK bit in the FEATURE register.
+ *
+ * @param 	handle Handle structure.
+ * @param 	tx_payload Transmit buffer.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_transmit_noack_pipelined(nrf24l01_handle_t handle, uint8_t* tx_payload, uint32_t timeout_ms);
+
+/*
+ * @brief   Read data on RX FIFO if any and clear RX_DR flag. Unlike
+ * 			"nrf24l01_receive_polling", this function returns immediately.
+ *
+ * @param 	handle Handle structure.
+ * @param 	rx_payload Received buffer.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Data is read.
+ *      - Others:           RX FIFO is empty or fail.
+ */
+err_code_t nrf24l01_try_receive(nrf24l01_handle_t handle, uint8_t* rx_payload);
+
+/*
+ * @brief   Switch between transmitter and receiver at runtime.
+ *
+ * @note 	CE is pulled low while bit PRIM_RX in the CONFIG register is changed.
+ * 			The radio needs 130 us to settle in the new mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	transceiver_mode Mode operation.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_transceiver_mode(nrf24l01_handle_t handle, nrf24l01_transceiver_mode_t transceiver_mode);
+
+/*
+ * @brief   Hold the shared SPI bus across the following transactions so that
+ * 			they run back to back without transactions of other handles in
+ * 			between. Without shared bus, this function only marks the batch.
+ *
+ * @note 	Batches are not nested. "nrf24l01_end_batch" must be called from the
+ * 			same thread.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_begin_batch(nrf24l01_handle_t handle);
+
+/*
+ * @brief   Release the shared SPI bus held by "nrf24l01_begin_batch".
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_end_batch(nrf24l01_handle_t handle);
+
+/*
+ * @brief   Read Received Power Detector. RPD is set when a signal above -64 dBm
+ * 			is present on the channel and is latched when the radio leaves RX.
+ *
+ * @note 	The radio must have been in RX mode for at least 170 us (130 us
+ * 			settling plus 40 us detection) to get a valid value.
+ *
+ * @param 	handle Handle structure.
+ * @param 	rpd Received power detected, 1 means channel is busy.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_get_rpd(nrf24l01_handle_t handle, uint8_t *rpd);
+
+/*
+ * @brief   Set address of the receiver. Only addr_width bytes are used, least
+ * 			significant byte first.
+ *
+ * @note 	To receive ACK, RX address of pipe 0 must be the same as TX address.
+ *
+ * @param 	handle Handle structure.
+ * @param 	addr Address.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_tx_address(nrf24l01_handle_t handle, uint8_t *addr);
+
+/*
+ * @brief   Set address of a data pipe, enable the pipe and set its payload
+ * 			width to packet_len.
+ *
+ * @note 	Pipes 2 to 5 share the upper bytes of pipe 1, only addr[0] is
+ * 			written for them.
+ *
+ * @param 	handle Handle structure.
+ * @param 	pipe Data pipe, 0 to 5.
+ * @param 	addr Address.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_rx_address(nrf24l01_handle_t handle, uint8_t pipe, uint8_t *addr);
+
+/*
+ * @brief   Disable a data pipe, the radio no longer receives nor acknowledges
+ * 			frames on its address.
+ *
+ * @param 	handle Handle structure.
+ * @param 	pipe Data pipe, 0 to 5.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_disable_rx_pipe(nrf24l01_handle_t handle, uint8_t pipe);
+
+/*
+ * @brief   Configure nRF24L01 from a register image computed in advance, for
+ * 			example at compile time. Same as "nrf24l01_config" without any
+ * 			register value computed or read back.
+ *
+ * @note 	"nrf24l01_set_config" must be called before with parameters matching
+ * 			the image.
+ *
+ * @param 	handle Handle structure.
+ * @param 	image Register image.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_config_image(nrf24l01_handle_t handle, const nrf24l01_reg_image_t *image);
+
+/*
+ * @brief   Check progress of payloads written to TX FIFO without waiting.
+ * 			TX_DS is cleared when asserted. TX_DS does not tell how many
+ * 			payloads are done, so all are counted done when TX FIFO is empty,
+ * 			otherwise one.
+ *
+ * @note 	If MAX_RT is asserted, TX FIFO is flushed, MAX_RT is cleared and
+ * 			this function fails, all "in_fifo" payloads are lost.
+ *
+ * @param 	handle Handle structure.
+ * @param 	in_fifo Payloads written to TX FIFO and not yet counted done.
+ * @param 	num_done Payloads done since last call.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, MAX_RT.
+ */
+err_code_t nrf24l01_get_tx_done(nrf24l01_handle_t handle, uint8_t in_fifo, uint8_t *num_done);
+
+/*
+ * @brief   Toggle bit PRIM_RX with a single register write from the cached
+ * 			CONFIG value. Unlike "nrf24l01_set_transceiver_mode", CONFIG is not
+ * 			read back, RX_PW_P0 is not written and the mode of the handle is not
+ * 			changed. Used for short listen windows such as carrier sense.
+ *
+ * @note 	The radio needs 130 us to settle in the new mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	prim_rx 1 for RX, 0 for TX.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_set_prim_rx(nrf24l01_handle_t handle, uint8_t prim_rx);
+
 #ifdef __cplusplus
 }
 #endif
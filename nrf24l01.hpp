@@ -0,0 +1,368 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_HPP__
+#define __NRF24L01_HPP__
+
+#include "nrf24l01.h"
+
+#if __cplusplus >= 202002L
+#include <coroutine>
+#endif
+
+namespace nrf24l01pp {
+
+/**
+ * @brief   Hardware functions, same as in "nrf24l01_cfg_t".
+ */
+struct hal {
+	nrf24l01_func_spi_send 		spi_send;			/*!< Function SPI send */
+	nrf24l01_func_spi_recv 		spi_recv;			/*!< Function SPI receive */
+	nrf24l01_func_set_gpio 		set_cs;				/*!< Function set chip select pin */
+	nrf24l01_func_set_gpio 		set_ce;				/*!< Function set chip enable pin */
+	nrf24l01_func_get_gpio 		get_irq;			/*!< Function get irq pin */
+	nrf24l01_func_delay			delay; 				/*!< Function delay */
+	nrf24l01_bus_handle_t 		bus;				/*!< Shared SPI bus, NULL if SPI is not shared */
+	nrf24l01_func_bus_acquire 	bus_acquire;		/*!< Function lock shared bus, optional */
+	nrf24l01_func_bus_release 	bus_release;		/*!< Function unlock shared bus, optional */
+};
+
+/**
+ * @brief   Compile-time configuration. Parameters are checked and turned into
+ * 			a register image by the compiler, an invalid combination does not
+ * 			compile.
+ */
+template <uint16_t Channel,
+          nrf24l01_data_rate_t DataRate = NRF24L01_DATA_RATE_1Mbps,
+          nrf24l01_output_pwr_t OutputPwr = NRF24L01_OUTPUT_PWR_0dBm,
+          uint8_t CrcLen = 2,
+          uint8_t AddrWidth = 5,
+          uint8_t PacketLen = 32,
+          uint8_t RetransCnt = 3,
+          uint16_t RetransDelay = 500,
+          nrf24l01_transceiver_mode_t Mode = NRF24L01_TRANSCEIVER_MODE_TX>
+struct config {
+	static_assert((Channel >= 2400) && (Channel <= 2525), "Channel must be 2400 to 2525 MHz");
+	static_assert(DataRate <= NRF24L01_DATA_RATE_2Mbps, "Invalid data rate");
+	static_assert(OutputPwr <= NRF24L01_OUTPUT_PWR_18dBm, "Invalid output power");
+	static_assert((CrcLen == 1) || (CrcLen == 2), "CRC must be 1 or 2 bytes, auto acknowledgment needs CRC");
+	static_assert((AddrWidth >= 3) && (AddrWidth <= 5), "Address width must be 3 to 5 bytes");
+	static_assert((PacketLen >= 1) && (PacketLen <= 32), "Packet length must be 1 to 32 bytes");
+	static_assert(RetransCnt <= 15, "Re-transmit count must be 0 to 15");
+	static_assert((RetransDelay >= 250) && (RetransDelay <= 4000) && ((RetransDelay % 250) == 0),
+	              "Re-transmit delay must be a multiple of 250 us up to 4000 us");
+	static_assert((DataRate != NRF24L01_DATA_RATE_250Kbps) || (RetransDelay >= 500),
+	              "Re-transmit delay must be at least 500 us at 250 Kbps");
+
+	static constexpr uint8_t rf_setup_pwr(void)
+	{
+		return (OutputPwr == NRF24L01_OUTPUT_PWR_0dBm) ? (3 << 1) :
+		       (OutputPwr == NRF24L01_OUTPUT_PWR_6dBm) ? (2 << 1) :
+		       (OutputPwr == NRF24L01_OUTPUT_PWR_12dBm) ? (1 << 1) : 0;
+	}
+
+	static constexpr uint8_t rf_setup_rate(void)
+	{
+		return (DataRate == NRF24L01_DATA_RATE_250Kbps) ? (1 << 5) :
+		       (DataRate == NRF24L01_DATA_RATE_2Mbps) ? (1 << 3) : 0;
+	}
+
+	static constexpr nrf24l01_reg_image_t image = {
+		/* CONFIG: EN_CRC, CRCO, PWR_UP, PRIM_RX */
+		static_cast<uint8_t>(0x08 | ((CrcLen == 2) ? 0x04 : 0x00) | 0x02 |
+		                     ((Mode == NRF24L01_TRANSCEIVER_MODE_RX) ? 0x01 : 0x00)),
+		/* EN_AA, EN_RXADDR */
+		0x3F,
+		0x03,
+		/* SETUP_AW */
+		static_cast<uint8_t>(AddrWidth - 2),
+		/* SETUP_RETR */
+		static_cast<uint8_t>((((RetransDelay / 250) - 1) << 4) | RetransCnt),
+		/* RF_CH */
+		static_cast<uint8_t>(Channel - 2400),
+		/* RF_SETUP */
+		static_cast<uint8_t>(0x01 | rf_setup_pwr() | rf_setup_rate()),
+		/* RX_PW_P0 */
+		static_cast<uint8_t>((Mode == NRF24L01_TRANSCEIVER_MODE_RX) ? PacketLen : 0),
+		/* FEATURE: enable W_TX_PAYLOAD_NOACK command */
+		0x01,
+	};
+
+	static constexpr uint8_t packet_len = PacketLen;
+
+	/*
+	 * @brief   Configuration structure with the same parameters as the image.
+	 */
+	static nrf24l01_cfg_t cfg(const hal &hw)
+	{
+		nrf24l01_cfg_t c = {};
+
+		c.channel = Channel;
+		c.packet_len = PacketLen;
+		c.crc_len = CrcLen;
+		c.addr_width = AddrWidth;
+		c.retrans_cnt = RetransCnt;
+		c.retrans_delay = RetransDelay;
+		c.data_rate = DataRate;
+		c.output_pwr = OutputPwr;
+		c.transceiver_mode = Mode;
+		c.spi_send = hw.spi_send;
+		c.spi_recv = hw.spi_recv;
+		c.set_cs = hw.set_cs;
+		c.set_ce = hw.set_ce;
+		c.get_irq = hw.get_irq;
+		c.delay = hw.delay;
+		c.bus = hw.bus;
+		c.bus_acquire = hw.bus_acquire;
+		c.bus_release = hw.bus_release;
+
+		return c;
+	}
+};
+
+#if __cplusplus < 201703L
+/* Static constexpr members are not implicitly inline before C++17 */
+template <uint16_t Channel, nrf24l01_data_rate_t DataRate, nrf24l01_output_pwr_t OutputPwr, uint8_t CrcLen,
+          uint8_t AddrWidth, uint8_t PacketLen, uint8_t RetransCnt, uint16_t RetransDelay,
+          nrf24l01_transceiver_mode_t Mode>
+constexpr nrf24l01_reg_image_t config<Channel, DataRate, OutputPwr, CrcLen, AddrWidth, PacketLen, RetransCnt,
+                                      RetransDelay, Mode>::image;
+
+template <uint16_t Channel, nrf24l01_data_rate_t DataRate, nrf24l01_output_pwr_t OutputPwr, uint8_t CrcLen,
+          uint8_t AddrWidth, uint8_t PacketLen, uint8_t RetransCnt, uint16_t RetransDelay,
+          nrf24l01_transceiver_mode_t Mode>
+constexpr uint8_t config<Channel, DataRate, OutputPwr, CrcLen, AddrWidth, PacketLen, RetransCnt,
+                         RetransDelay, Mode>::packet_len;
+#endif
+
+/**
+ * @brief   Radio bound to a compile-time configuration.
+ *
+ * @note 	The C driver has no deinit function, a radio lives as long as the
+ * 			program.
+ */
+template <typename Config>
+class radio {
+public:
+	explicit radio(const hal &hw) : handle_(nrf24l01_init()), hw_(hw)
+	{
+	}
+
+	radio(const radio &) = delete;
+	radio &operator=(const radio &) = delete;
+
+	/*
+	 * @brief   Configure the radio from the compile-time register image.
+	 */
+	err_code_t begin(void)
+	{
+		err_code_t err_ret = nrf24l01_set_config(handle_, Config::cfg(hw_));
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+
+		return nrf24l01_config_image(handle_, &Config::image);
+	}
+
+	nrf24l01_handle_t handle(void) const
+	{
+		return handle_;
+	}
+
+#if __cplusplus >= 202002L
+	/**
+	 * @brief   Awaitable transmission. The payload is written to TX FIFO when
+	 * 			the coroutine suspends, it is resumed by "on_irq" on TX_DS or
+	 * 			MAX_RT. The result is ERR_CODE_SUCCESS when acknowledged.
+	 */
+	class tx_awaitable {
+	public:
+		tx_awaitable(radio &r, uint8_t *payload) : radio_(r), payload_(payload), result_(ERR_CODE_FAIL)
+		{
+		}
+
+		bool await_ready(void) const noexcept
+		{
+			return false;
+		}
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			/* One transmission at a time */
+			if (radio_.tx_waiter_ != nullptr)
+			{
+				return false;
+			}
+
+			radio_.tx_waiter_ = this;
+			waiter_ = h;
+
+			if (nrf24l01_transmit(radio_.handle_, payload_) != ERR_CODE_SUCCESS)
+			{
+				radio_.tx_waiter_ = nullptr;
+				return false;
+			}
+
+			return true;
+		}
+
+		err_code_t await_resume(void) const noexcept
+		{
+			return result_;
+		}
+
+	private:
+		friend class radio;
+
+		radio 					&radio_;
+		uint8_t 				*payload_;
+		err_code_t 				result_;
+		std::coroutine_handle<> waiter_;
+	};
+
+	/**
+	 * @brief   Awaitable reception. Completes at once if RX FIFO holds data,
+	 * 			otherwise the coroutine is resumed by "on_irq" on RX_DR.
+	 */
+	class rx_awaitable {
+	public:
+		rx_awaitable(radio &r, uint8_t *payload) : radio_(r), payload_(payload), result_(ERR_CODE_FAIL)
+		{
+		}
+
+		bool await_ready(void) noexcept
+		{
+			result_ = nrf24l01_try_receive(radio_.handle_, payload_);
+
+			return (result_ == ERR_CODE_SUCCESS);
+		}
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			/* One reception at a time */
+			if (radio_.rx_waiter_ != nullptr)
+			{
+				return false;
+			}
+
+			radio_.rx_waiter_ = this;
+			waiter_ = h;
+
+			return true;
+		}
+
+		err_code_t await_resume(void) const noexcept
+		{
+			return result_;
+		}
+
+	private:
+		friend class radio;
+
+		radio 					&radio_;
+		uint8_t 				*payload_;
+		err_code_t 				result_;
+		std::coroutine_handle<> waiter_;
+	};
+
+	tx_awaitable transmit(uint8_t *payload)
+	{
+		return tx_awaitable(*this, payload);
+	}
+
+	rx_awaitable receive(uint8_t *payload)
+	{
+		return rx_awaitable(*this, payload);
+	}
+
+	/*
+	 * @brief   Handle IRQ of the radio and resume waiting coroutines.
+	 *
+	 * @note 	Call from task context after the IRQ pin is asserted, not from
+	 * 			the interrupt handler, since it uses SPI and runs coroutines.
+	 * 			RX_DR is always cleared, a payload received while no coroutine
+	 * 			waits is returned by the next "receive".
+	 */
+	void on_irq(void)
+	{
+		uint8_t status;
+
+		nrf24l01_get_status(handle_, &status);
+
+		if (status & NRF24L01_STATUS_MAX_RT)
+		{
+			nrf24l01_flush_tx_fifo(handle_);
+			nrf24l01_clear_max_rt(handle_);
+			complete_tx(ERR_CODE_FAIL);
+		}
+		else if (status & NRF24L01_STATUS_TX_DS)
+		{
+			nrf24l01_clear_tx_ds(handle_);
+			complete_tx(ERR_CODE_SUCCESS);
+		}
+
+		if (status & NRF24L01_STATUS_RX_DR)
+		{
+			/* RX_DR is cleared by nrf24l01_try_receive */
+			rx_awaitable *waiter = rx_waiter_;
+
+			if ((waiter != nullptr) && (nrf24l01_try_receive(handle_, waiter->payload_) == ERR_CODE_SUCCESS))
+			{
+				waiter->result_ = ERR_CODE_SUCCESS;
+				rx_waiter_ = nullptr;
+				waiter->waiter_.resume();
+			}
+			else
+			{
+				/* Release IRQ pin, payload stays in RX FIFO for next "receive" */
+				nrf24l01_clear_rx_dr(handle_);
+			}
+		}
+	}
+
+private:
+	void complete_tx(err_code_t result)
+	{
+		tx_awaitable *waiter = tx_waiter_;
+		if (waiter == nullptr)
+		{
+			return;
+		}
+
+		tx_waiter_ = nullptr;
+		waiter->result_ = result;
+		waiter->waiter_.resume();
+	}
+
+	tx_awaitable 				*tx_waiter_ = nullptr;
+	rx_awaitable 				*rx_waiter_ = nullptr;
+#endif
+
+private:
+	nrf24l01_handle_t 			handle_;
+	hal 						hw_;
+};
+
+} /* namespace nrf24l01pp */
+
+#endif /* __NRF24L01_HPP__ */
@@ -0,0 +1,288 @@
+#include "stdlib.h"
+#include "nrf24l01_adapt.h"
+
+#define NRF24L01_ADAPT_MAX_RETRANS_CNT 		15
+#define NRF24L01_ADAPT_MAX_PROBE_BACKOFF 	3
+
+/**
+ * @brief   Air data rate in kbps, index by nrf24l01_data_rate_t.
+ */
+static const uint16_t nrf24l01_adapt_rate_kbps[] = {250, 1000, 2000};
+
+/**
+ * @brief   Shortest retransmit delay in us that fits an empty ACK, index by
+ * 			nrf24l01_data_rate_t. ACK with payload needs a longer delay, which
+ * 			is kept if configured on the radio.
+ */
+static const uint16_t nrf24l01_adapt_retrans_delay[] = {500, 250, 250};
+
+typedef struct nrf24l01_adapt {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					window_len;			/*!< Number of transmissions per evaluation window */
+	uint8_t 					retry_high;			/*!< Average retries x10 above which link is degraded */
+	uint8_t 					retry_low;			/*!< Average retries x10 below which link is clean */
+	uint8_t 					loss_high;			/*!< Lost packets percent above which link is degraded */
+	uint8_t 					hysteresis;			/*!< Consecutive clean windows before lowering output power */
+	uint8_t 					min_retrans_cnt;	/*!< Lower limit of re-transmit count */
+	nrf24l01_output_pwr_t 		min_output_pwr;		/*!< Lowest output power allowed on a clean link */
+	nrf24l01_data_rate_t 		data_rate;			/*!< Data rate of the radio, not changed */
+	uint16_t 					retrans_delay;		/*!< Re-transmit delay */
+	nrf24l01_output_pwr_t 		output_pwr;			/*!< Current output power */
+	uint8_t 					retrans_cnt;		/*!< Current re-transmit count */
+	uint16_t 					win_tx;				/*!< Transmissions in current window */
+	uint16_t 					win_lost;			/*!< Lost packets in current window */
+	uint32_t 					win_retry;			/*!< Retransmits in current window */
+	uint8_t 					win_max_arc;		/*!< Highest ARC_CNT in current window */
+	uint8_t 					clean_cnt;			/*!< Consecutive clean windows */
+	uint8_t 					probe_backoff;		/*!< Hysteresis multiplier after failed probes, power of 2 */
+	uint8_t 					probing;			/*!< Output power has just been decreased */
+	nrf24l01_adapt_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_adapt_t;
+
+static err_code_t nrf24l01_adapt_apply(nrf24l01_adapt_handle_t handle, nrf24l01_output_pwr_t output_pwr)
+{
+	err_code_t err_ret;
+
+	if (output_pwr != handle->output_pwr)
+	{
+		err_ret = nrf24l01_set_output_power(handle->radio, output_pwr);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+
+		/* Enum counts attenuation, lower value is higher power */
+		if (output_pwr < handle->output_pwr)
+		{
+			handle->stats.num_pwr_up++;
+		}
+		else
+		{
+			handle->stats.num_pwr_down++;
+		}
+
+		handle->output_pwr = output_pwr;
+	}
+
+	return nrf24l01_set_auto_retransmit(handle->radio, handle->retrans_cnt, handle->retrans_delay);
+}
+
+static err_code_t nrf24l01_adapt_evaluate(nrf24l01_adapt_handle_t handle)
+{
+	nrf24l01_output_pwr_t output_pwr = handle->output_pwr;
+
+	if (handle->win_lost > handle->win_tx)
+	{
+		handle->win_lost = handle->win_tx;
+	}
+
+	uint32_t loss_pct = ((uint32_t)handle->win_lost * 100) / handle->win_tx;
+	uint32_t retry_x10 = (handle->win_retry * 10) / handle->win_tx;
+
+	/* Every attempt costs one air slot, only delivered packets count */
+	handle->stats.goodput = ((uint32_t)nrf24l01_adapt_rate_kbps[handle->data_rate] * (handle->win_tx - handle->win_lost)) /
+	                        (handle->win_tx + handle->win_retry);
+
+	uint8_t degraded = (loss_pct > handle->loss_high) || (retry_x10 > handle->retry_high);
+	uint8_t clean = (handle->win_lost == 0) && (retry_x10 <= handle->retry_low);
+
+	if (handle->probing)
+	{
+		handle->probing = 0;
+
+		/* Lower output power degraded the link, revert and wait longer before next probe */
+		if (degraded)
+		{
+			output_pwr--;
+			handle->clean_cnt = 0;
+			handle->stats.num_probe_fail++;
+			if (handle->probe_backoff < NRF24L01_ADAPT_MAX_PROBE_BACKOFF)
+			{
+				handle->probe_backoff++;
+			}
+
+			degraded = 0;
+			clean = 0;
+		}
+		else
+		{
+			handle->probe_backoff = 0;
+		}
+	}
+
+	if (degraded)
+	{
+		handle->clean_cnt = 0;
+
+		if (output_pwr > NRF24L01_OUTPUT_PWR_0dBm)
+		{
+			output_pwr--;
+		}
+	}
+	else if (clean)
+	{
+		handle->clean_cnt++;
+
+		if (handle->clean_cnt >= (handle->hysteresis << handle->probe_backoff))
+		{
+			handle->clean_cnt = 0;
+
+			if (output_pwr < handle->min_output_pwr)
+			{
+				handle->probing = 1;
+				output_pwr++;
+			}
+		}
+	}
+	else
+	{
+		handle->clean_cnt = 0;
+	}
+
+	/* Allow more retries while packets are lost, shrink back when unused */
+	if ((handle->win_lost != 0) && (handle->retrans_cnt < NRF24L01_ADAPT_MAX_RETRANS_CNT))
+	{
+		handle->retrans_cnt += 2;
+		if (handle->retrans_cnt > NRF24L01_ADAPT_MAX_RETRANS_CNT)
+		{
+			handle->retrans_cnt = NRF24L01_ADAPT_MAX_RETRANS_CNT;
+		}
+	}
+	else if ((handle->win_lost == 0) &&
+	         ((handle->win_max_arc + 2) < handle->retrans_cnt) &&
+	         (handle->retrans_cnt > handle->min_retrans_cnt))
+	{
+		handle->retrans_cnt--;
+	}
+
+	handle->win_tx = 0;
+	handle->win_lost = 0;
+	handle->win_retry = 0;
+	handle->win_max_arc = 0;
+
+	return nrf24l01_adapt_apply(handle, output_pwr);
+}
+
+nrf24l01_adapt_handle_t nrf24l01_adapt_init(void)
+{
+	nrf24l01_adapt_handle_t handle = calloc(1, sizeof(nrf24l01_adapt_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_adapt_set_config(nrf24l01_adapt_handle_t handle, nrf24l01_adapt_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->window_len = config.window_len;
+	handle->retry_high = config.retry_high;
+	handle->retry_low = config.retry_low;
+	handle->loss_high = config.loss_high;
+	handle->hysteresis = config.hysteresis;
+	handle->min_retrans_cnt = config.min_retrans_cnt;
+	handle->min_output_pwr = config.min_output_pwr;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_adapt_config(nrf24l01_adapt_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->window_len == 0) || (handle->hysteresis == 0) ||
+	    (handle->min_retrans_cnt > NRF24L01_ADAPT_MAX_RETRANS_CNT))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	handle->data_rate = radio_cfg.data_rate;
+	handle->output_pwr = radio_cfg.output_pwr;
+	handle->retrans_delay = radio_cfg.retrans_delay;
+	if (handle->retrans_delay < nrf24l01_adapt_retrans_delay[handle->data_rate])
+	{
+		handle->retrans_delay = nrf24l01_adapt_retrans_delay[handle->data_rate];
+	}
+	handle->retrans_cnt = radio_cfg.retrans_cnt;
+	if (handle->retrans_cnt < handle->min_retrans_cnt)
+	{
+		handle->retrans_cnt = handle->min_retrans_cnt;
+	}
+
+	handle->win_tx = 0;
+	handle->win_lost = 0;
+	handle->win_retry = 0;
+	handle->win_max_arc = 0;
+	handle->clean_cnt = 0;
+	handle->probe_backoff = 0;
+	handle->probing = 0;
+
+	nrf24l01_clear_plos_cnt(handle->radio);
+
+	return nrf24l01_adapt_apply(handle, handle->output_pwr);
+}
+
+err_code_t nrf24l01_adapt_update(nrf24l01_adapt_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t plos_cnt, arc_cnt;
+	nrf24l01_get_observe_tx(handle->radio, &plos_cnt, &arc_cnt);
+
+	/* PLOS_CNT saturates at 15, reset it whenever it moves */
+	if (plos_cnt != 0)
+	{
+		nrf24l01_clear_plos_cnt(handle->radio);
+	}
+
+	handle->win_tx++;
+	handle->win_lost += plos_cnt;
+	handle->win_retry += arc_cnt;
+	if (arc_cnt > handle->win_max_arc)
+	{
+		handle->win_max_arc = arc_cnt;
+	}
+
+	handle->stats.num_tx++;
+	handle->stats.num_lost += plos_cnt;
+	handle->stats.num_retry += arc_cnt;
+
+	if (handle->win_tx < handle->window_len)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	return nrf24l01_adapt_evaluate(handle);
+}
+
+err_code_t nrf24l01_adapt_get_stats(nrf24l01_adapt_handle_t handle, nrf24l01_adapt_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,145 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_ADAPT_H__
+#define __NRF24L01_ADAPT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Link adaptation adjusts output power and ARC/ARD of the local radio
+ * 			only. Data rate is never changed, since the peer is not told and
+ * 			both ends must use the same data rate.
+ */
+
+/**
+ * @brief   Link adaptation handle structure.
+ */
+typedef struct nrf24l01_adapt* nrf24l01_adapt_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					window_len;			/*!< Number of transmissions per evaluation window */
+	uint8_t 					retry_high;			/*!< Average retries x10 above which link is degraded */
+	uint8_t 					retry_low;			/*!< Average retries x10 below which link is clean */
+	uint8_t 					loss_high;			/*!< Lost packets percent above which link is degraded */
+	uint8_t 					hysteresis;			/*!< Consecutive clean windows before lowering output power */
+	uint8_t 					min_retrans_cnt;	/*!< Lower limit of re-transmit count */
+	nrf24l01_output_pwr_t 		min_output_pwr;		/*!< Lowest output power allowed on a clean link */
+} nrf24l01_adapt_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_tx;				/*!< Transmissions reported */
+	uint32_t 					num_lost;			/*!< Packets lost after maximum retransmits */
+	uint32_t 					num_retry;			/*!< Total retransmits */
+	uint16_t 					num_pwr_up;			/*!< Output power increased */
+	uint16_t 					num_pwr_down;		/*!< Output power decreased */
+	uint16_t 					num_probe_fail;		/*!< Output power decreased then reverted */
+	uint32_t 					goodput;			/*!< Goodput estimation of last window in kbps */
+} nrf24l01_adapt_stats_t;
+
+/*
+ * @brief   Initialize link adaptation controller.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_adapt_handle_t nrf24l01_adapt_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_adapt_set_config(nrf24l01_adapt_handle_t handle, nrf24l01_adapt_cfg_t config);
+
+/*
+ * @brief   Configure link adaptation controller to run. Starting point is the
+ * 			output power and retransmit count currently applied on the radio.
+ * 			ARD is the shortest delay fitting an empty ACK at the data rate of
+ * 			the radio (500 us at 250 Kbps, 250 us otherwise), or the configured
+ * 			delay if longer. Configure a longer delay when ACK carries payload.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_adapt_config(nrf24l01_adapt_handle_t handle);
+
+/*
+ * @brief   Report one completed transmission. OBSERVE_TX register is read to
+ * 			collect retransmit and lost packet counters. At the end of each
+ * 			window, output power and ARC/ARD are updated.
+ *
+ * @note 	This function should be called after each transmission completes,
+ * 			i.e. TX_DS or MAX_RT is asserted, before next payload is written.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_adapt_update(nrf24l01_adapt_handle_t handle);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_adapt_get_stats(nrf24l01_adapt_handle_t handle, nrf24l01_adapt_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_ADAPT_H__ */
@@ -0,0 +1,488 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_arq.h"
+
+#define NRF24L01_ARQ_TYPE_DATA 			0x01
+#define NRF24L01_ARQ_TYPE_ACK 			0x02
+#define NRF24L01_ARQ_TYPE_MASK 			0x0F
+#define NRF24L01_ARQ_FLAG_POLL 			0x10
+#define NRF24L01_ARQ_FLAG_LAST 			0x20
+
+#define NRF24L01_ARQ_MIN_PACKET_LEN 	8
+#define NRF24L01_ARQ_MAX_FRAME_CNT 		0xFFFF
+
+/**
+ * @brief   State of a frame in flight, index by sequence number modulo window size.
+ */
+typedef struct {
+	uint32_t 					sent_tick;			/*!< Tick of last transmission */
+	uint8_t 					tx_cnt;				/*!< Number of transmissions */
+	uint8_t 					acked;				/*!< Frame is acknowledged */
+	uint8_t 					nack;				/*!< Frame is reported missing */
+} nrf24l01_arq_slot_t;
+
+typedef struct nrf24l01_arq {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					window_size;		/*!< Frames in flight */
+	uint8_t 					max_retry;			/*!< Retransmits of one frame before transfer fails */
+	uint32_t 					rto_ms;				/*!< Retransmit timeout of an unacknowledged frame */
+	uint32_t 					ack_timeout_ms;		/*!< Time waiting for ACK after a burst */
+	uint32_t 					linger_ms;			/*!< Time receiver keeps answering after completion */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	nrf24l01_func_delay 		delay;				/*!< Function delay of the radio */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					*frame;				/*!< Frame buffer, packet_len bytes */
+	uint8_t 					tx_session;			/*!< Session id of current transmitted transfer */
+	uint8_t 					rx_session;			/*!< Session id of last completed received transfer */
+	uint8_t 					rx_session_valid;	/*!< A received transfer has completed */
+	nrf24l01_arq_slot_t 		slot[NRF24L01_ARQ_MAX_WINDOW_SIZE];	/*!< Frames in flight */
+	nrf24l01_arq_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_arq_t;
+
+static err_code_t nrf24l01_arq_send_data(nrf24l01_arq_handle_t handle, uint8_t *data, uint32_t len, uint32_t frame_cnt, uint32_t seq, uint8_t poll)
+{
+	uint8_t chunk_len = handle->packet_len - NRF24L01_ARQ_HEADER_LEN;
+	uint32_t offset = seq * chunk_len;
+	uint8_t data_len = ((len - offset) > chunk_len) ? chunk_len : (len - offset);
+	nrf24l01_arq_slot_t *slot = &handle->slot[seq % handle->window_size];
+
+	handle->frame[0] = NRF24L01_ARQ_TYPE_DATA;
+	if (poll)
+	{
+		handle->frame[0] |= NRF24L01_ARQ_FLAG_POLL;
+	}
+	if (seq == (frame_cnt - 1))
+	{
+		handle->frame[0] |= NRF24L01_ARQ_FLAG_LAST;
+	}
+	handle->frame[1] = handle->tx_session;
+	handle->frame[2] = seq & 0xFF;
+	handle->frame[3] = (seq >> 8) & 0xFF;
+	handle->frame[4] = data_len;
+	memcpy(&handle->frame[NRF24L01_ARQ_HEADER_LEN], &data[offset], data_len);
+	memset(&handle->frame[NRF24L01_ARQ_HEADER_LEN + data_len], 0, chunk_len - data_len);
+
+	if (slot->tx_cnt != 0)
+	{
+		handle->stats.num_retrans++;
+	}
+	handle->stats.num_data_tx++;
+
+	slot->sent_tick = handle->get_tick();
+	slot->tx_cnt++;
+	slot->nack = 0;
+
+	return nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, handle->ack_timeout_ms);
+}
+
+static void nrf24l01_arq_process_ack(nrf24l01_arq_handle_t handle, uint32_t *base, uint32_t next)
+{
+	uint32_t ack_next = handle->frame[2] | (handle->frame[3] << 8);
+	uint32_t bitmap = handle->frame[4] | (handle->frame[5] << 8) | (handle->frame[6] << 16) | ((uint32_t)handle->frame[7] << 24);
+	uint32_t highest;
+
+	if (ack_next > next)
+	{
+		ack_next = next;
+	}
+
+	/* Cumulative part */
+	for (uint32_t seq = *base; seq < ack_next; seq++)
+	{
+		handle->slot[seq % handle->window_size].acked = 1;
+	}
+
+	/* Selective part, frames before the highest received one are lost */
+	highest = ack_next;
+	for (uint8_t i = 0; i < 32; i++)
+	{
+		uint32_t seq = ack_next + 1 + i;
+		if (seq >= next)
+		{
+			break;
+		}
+
+		if ((seq >= *base) && (bitmap & ((uint32_t)1 << i)))
+		{
+			handle->slot[seq % handle->window_size].acked = 1;
+			highest = seq;
+		}
+	}
+
+	for (uint32_t seq = ack_next; seq < highest; seq++)
+	{
+		if ((seq >= *base) && !handle->slot[seq % handle->window_size].acked)
+		{
+			handle->slot[seq % handle->window_size].nack = 1;
+		}
+	}
+
+	while ((*base < next) && handle->slot[*base % handle->window_size].acked)
+	{
+		(*base)++;
+	}
+}
+
+static err_code_t nrf24l01_arq_send_ack(nrf24l01_arq_handle_t handle, uint8_t session, uint32_t expected, uint32_t bitmap)
+{
+	err_code_t err_ret;
+
+	memset(handle->frame, 0, handle->packet_len);
+	handle->frame[0] = NRF24L01_ARQ_TYPE_ACK;
+	handle->frame[1] = session;
+	handle->frame[2] = expected & 0xFF;
+	handle->frame[3] = (expected >> 8) & 0xFF;
+	handle->frame[4] = bitmap & 0xFF;
+	handle->frame[5] = (bitmap >> 8) & 0xFF;
+	handle->frame[6] = (bitmap >> 16) & 0xFF;
+	handle->frame[7] = (bitmap >> 24) & 0xFF;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	err_ret = nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, handle->ack_timeout_ms);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->ack_timeout_ms);
+	}
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	handle->stats.num_ack_tx++;
+
+	return err_ret;
+}
+
+nrf24l01_arq_handle_t nrf24l01_arq_init(void)
+{
+	nrf24l01_arq_handle_t handle = calloc(1, sizeof(nrf24l01_arq_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_arq_set_config(nrf24l01_arq_handle_t handle, nrf24l01_arq_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->window_size = config.window_size;
+	handle->max_retry = config.max_retry;
+	handle->rto_ms = config.rto_ms;
+	handle->ack_timeout_ms = config.ack_timeout_ms;
+	handle->linger_ms = config.linger_ms;
+	handle->get_tick = config.get_tick;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_arq_config(nrf24l01_arq_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->window_size == 0) || (handle->window_size > NRF24L01_ARQ_MAX_WINDOW_SIZE) ||
+	    (handle->get_tick == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if ((radio_cfg.packet_len < NRF24L01_ARQ_MIN_PACKET_LEN) || (radio_cfg.delay == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+	handle->delay = radio_cfg.delay;
+
+	free(handle->frame);
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	if (handle->frame == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_arq_transmit(nrf24l01_arq_handle_t handle, uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || ((data == NULL) && (len != 0)))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t chunk_len = handle->packet_len - NRF24L01_ARQ_HEADER_LEN;
+	uint32_t frame_cnt = (len + chunk_len - 1) / chunk_len;
+	if (frame_cnt == 0)
+	{
+		frame_cnt = 1;
+	}
+
+	if (frame_cnt > NRF24L01_ARQ_MAX_FRAME_CNT)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret;
+	uint32_t base = 0;
+	uint32_t next = 0;
+	uint32_t burst[NRF24L01_ARQ_MAX_WINDOW_SIZE];
+	uint8_t burst_len;
+	uint32_t start = handle->get_tick();
+
+	handle->tx_session++;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	while (base < frame_cnt)
+	{
+		uint32_t now = handle->get_tick();
+		if ((now - start) >= timeout_ms)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		/* Frames reported missing or with expired timer */
+		burst_len = 0;
+		for (uint32_t seq = base; seq < next; seq++)
+		{
+			nrf24l01_arq_slot_t *slot = &handle->slot[seq % handle->window_size];
+
+			if (!slot->acked && (slot->nack || ((now - slot->sent_tick) >= handle->rto_ms)))
+			{
+				if (slot->tx_cnt > handle->max_retry)
+				{
+					return ERR_CODE_FAIL;
+				}
+
+				burst[burst_len++] = seq;
+			}
+		}
+
+		/* New frames while window is open */
+		while ((next < frame_cnt) && (next < (base + handle->window_size)))
+		{
+			memset(&handle->slot[next % handle->window_size], 0, sizeof(nrf24l01_arq_slot_t));
+			burst[burst_len++] = next++;
+		}
+
+		if (burst_len == 0)
+		{
+			handle->delay(1);
+			continue;
+		}
+
+		for (uint8_t i = 0; i < burst_len; i++)
+		{
+			err_ret = nrf24l01_arq_send_data(handle, data, len, frame_cnt, burst[i], i == (burst_len - 1));
+			if (err_ret != ERR_CODE_SUCCESS)
+			{
+				return err_ret;
+			}
+		}
+
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->ack_timeout_ms);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+
+		/* Wait for ACK frame of the burst */
+		nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+		uint8_t ack_received = 0;
+		uint32_t ack_start = handle->get_tick();
+		while ((handle->get_tick() - ack_start) < handle->ack_timeout_ms)
+		{
+			if (nrf24l01_try_receive(handle->radio, handle->frame) != ERR_CODE_SUCCESS)
+			{
+				handle->delay(1);
+				continue;
+			}
+
+			if ((handle->frame[0] & NRF24L01_ARQ_TYPE_MASK) != NRF24L01_ARQ_TYPE_ACK)
+			{
+				continue;
+			}
+
+			/* ACK of an earlier transfer */
+			if (handle->frame[1] != handle->tx_session)
+			{
+				handle->stats.num_stale++;
+				continue;
+			}
+
+			nrf24l01_arq_process_ack(handle, &base, next);
+			ack_received = 1;
+			break;
+		}
+
+		nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+		if (ack_received)
+		{
+			handle->stats.num_ack_rx++;
+		}
+		else
+		{
+			handle->stats.num_ack_timeout++;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_arq_receive(nrf24l01_arq_handle_t handle, uint8_t *buf, uint32_t buf_size, uint32_t *len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (buf == NULL) || (len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t chunk_len = handle->packet_len - NRF24L01_ARQ_HEADER_LEN;
+	uint32_t expected = 0;
+	uint32_t bitmap = 0;
+	uint32_t frame_cnt = 0;
+	uint32_t data_len = 0;
+	uint8_t session = 0;
+	uint8_t synced = 0;
+	uint8_t complete = 0;
+	uint32_t start = handle->get_tick();
+	uint32_t complete_tick = 0;
+
+	*len = 0;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	while (1)
+	{
+		uint32_t now = handle->get_tick();
+		if (complete)
+		{
+			if ((now - complete_tick) >= handle->linger_ms)
+			{
+				handle->rx_session = session;
+				handle->rx_session_valid = 1;
+				*len = data_len;
+				return ERR_CODE_SUCCESS;
+			}
+		}
+		else if ((now - start) >= timeout_ms)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (nrf24l01_try_receive(handle->radio, handle->frame) != ERR_CODE_SUCCESS)
+		{
+			handle->delay(1);
+			continue;
+		}
+
+		if ((handle->frame[0] & NRF24L01_ARQ_TYPE_MASK) != NRF24L01_ARQ_TYPE_DATA)
+		{
+			continue;
+		}
+
+		/* Lock on the first new session, drop frames of other transfers */
+		if (!synced)
+		{
+			if (handle->rx_session_valid && (handle->frame[1] == handle->rx_session))
+			{
+				handle->stats.num_stale++;
+				continue;
+			}
+
+			session = handle->frame[1];
+			synced = 1;
+		}
+		else if (handle->frame[1] != session)
+		{
+			handle->stats.num_stale++;
+			continue;
+		}
+
+		uint8_t flags = handle->frame[0];
+		uint32_t seq = handle->frame[2] | (handle->frame[3] << 8);
+		uint8_t frame_len = handle->frame[4];
+		uint32_t offset = seq * chunk_len;
+
+		if (frame_len > chunk_len)
+		{
+			continue;
+		}
+
+		if ((seq >= expected) && ((seq - expected) <= NRF24L01_ARQ_MAX_WINDOW_SIZE))
+		{
+			if ((offset + frame_len) > buf_size)
+			{
+				return ERR_CODE_FAIL;
+			}
+
+			memcpy(&buf[offset], &handle->frame[NRF24L01_ARQ_HEADER_LEN], frame_len);
+
+			if (flags & NRF24L01_ARQ_FLAG_LAST)
+			{
+				frame_cnt = seq + 1;
+				data_len = offset + frame_len;
+			}
+
+			if (seq == expected)
+			{
+				/* Slide over frames already received out of order */
+				expected++;
+				while (bitmap & 1)
+				{
+					bitmap >>= 1;
+					expected++;
+				}
+				bitmap >>= 1;
+			}
+			else
+			{
+				bitmap |= (uint32_t)1 << (seq - expected - 1);
+			}
+		}
+
+		uint8_t just_complete = !complete && (frame_cnt != 0) && (expected >= frame_cnt);
+
+		if ((flags & NRF24L01_ARQ_FLAG_POLL) || just_complete)
+		{
+			nrf24l01_arq_send_ack(handle, session, expected, bitmap);
+		}
+
+		if (just_complete)
+		{
+			complete = 1;
+			complete_tick = handle->get_tick();
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_arq_get_stats(nrf24l01_arq_handle_t handle, nrf24l01_arq_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,165 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_ARQ_H__
+#define __NRF24L01_ARQ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Frame layout. DATA frame carries type, session id, 16-bit sequence
+ * 			number and data length, packet_len - 5 bytes of data remain. ACK
+ * 			frame carries type, session id, next expected sequence number and
+ * 			a 32-bit bitmap of frames received after it. Packet length must be
+ * 			at least 8 bytes. Session id changes on each transfer, so frames
+ * 			left from an earlier transfer are dropped.
+ */
+#define NRF24L01_ARQ_HEADER_LEN 		5
+#define NRF24L01_ARQ_MAX_WINDOW_SIZE 	32
+
+/**
+ * @brief   Sliding window transport handle structure.
+ */
+typedef struct nrf24l01_arq* nrf24l01_arq_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					window_size;		/*!< Frames in flight, 1 to 32 */
+	uint8_t 					max_retry;			/*!< Retransmits of one frame before transfer fails */
+	uint32_t 					rto_ms;				/*!< Retransmit timeout of an unacknowledged frame */
+	uint32_t 					ack_timeout_ms;		/*!< Time waiting for ACK after a burst */
+	uint32_t 					linger_ms;			/*!< Time receiver keeps answering after completion */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+} nrf24l01_arq_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_data_tx;		/*!< DATA frames transmitted, retransmits included */
+	uint32_t 					num_retrans;		/*!< DATA frames retransmitted */
+	uint32_t 					num_ack_tx;			/*!< ACK frames transmitted */
+	uint32_t 					num_ack_rx;			/*!< ACK frames received */
+	uint32_t 					num_ack_timeout;	/*!< Bursts without ACK */
+	uint32_t 					num_stale;			/*!< Frames of another session dropped */
+} nrf24l01_arq_stats_t;
+
+/*
+ * @brief   Initialize sliding window transport.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_arq_handle_t nrf24l01_arq_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_arq_set_config(nrf24l01_arq_handle_t handle, nrf24l01_arq_cfg_t config);
+
+/*
+ * @brief   Configure sliding window transport to run.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_arq_config(nrf24l01_arq_handle_t handle);
+
+/*
+ * @brief   Transmit data reliably. Up to "window_size" frames are sent without
+ * 			ACK request, the last frame of each burst asks the receiver for an
+ * 			ACK frame. Frames reported missing are retransmitted at once, others
+ * 			when "rto_ms" expires.
+ *
+ * @note 	Radio is switched between TX and RX mode and left in TX mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	data Transmit buffer.
+ * @param 	len Data length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_arq_transmit(nrf24l01_arq_handle_t handle, uint8_t *data, uint32_t len, uint32_t timeout_ms);
+
+/*
+ * @brief   Receive data reliably. Frames are written directly at their offset
+ * 			in the receive buffer, so no reorder buffer is needed.
+ *
+ * @note 	Radio is switched between RX and TX mode and left in RX mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	buf Received buffer.
+ * @param 	buf_size Received buffer size.
+ * @param 	len Received data length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_arq_receive(nrf24l01_arq_handle_t handle, uint8_t *buf, uint32_t buf_size, uint32_t *len, uint32_t timeout_ms);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_arq_get_stats(nrf24l01_arq_handle_t handle, nrf24l01_arq_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_ARQ_H__ */
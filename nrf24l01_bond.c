@@ -0,0 +1,457 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_bond.h"
+
+/**
+ * @brief   TX queue of one radio. Frames stay in the queue until the radio
+ * 			confirms them, the first "in_fifo" frames are in TX FIFO.
+ */
+typedef struct {
+	uint8_t 					*buf;				/*!< Frames, queue_len * packet_len bytes */
+	uint8_t 					head;				/*!< Oldest frame */
+	uint8_t 					count;				/*!< Frames in queue */
+	uint8_t 					in_fifo;			/*!< Frames written to TX FIFO */
+	uint8_t 					up;					/*!< Link is up */
+	uint8_t 					fail_cnt;			/*!< Consecutive MAX_RT */
+	uint32_t 					down_tick;			/*!< Tick when link was taken down */
+} nrf24l01_bond_link_t;
+
+typedef struct nrf24l01_bond {
+	nrf24l01_handle_t 			radio[NRF24L01_BOND_MAX_RADIO];	/*!< Radio handles */
+	uint8_t 					num_radio;			/*!< Number of bonded radios */
+	uint8_t 					queue_len;			/*!< TX queue length of each radio */
+	uint8_t 					reorder_len;		/*!< Reorder buffer length */
+	uint32_t 					reorder_timeout_ms;	/*!< Time a missing frame is waited for */
+	uint8_t 					max_fail;			/*!< Consecutive MAX_RT before a link is taken down */
+	uint32_t 					probe_interval_ms;	/*!< Time before a link taken down is tried again */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	uint8_t 					packet_len;			/*!< Packet length of the radios */
+	uint8_t 					data_len;			/*!< Data length of one frame */
+	uint16_t 					tx_seq;				/*!< Next transmitted sequence number */
+	nrf24l01_bond_link_t 		link[NRF24L01_BOND_MAX_RADIO];	/*!< TX queues */
+	uint8_t 					*frame;				/*!< Frame buffer, packet_len bytes */
+	uint8_t 					*reorder_buf;		/*!< Reorder buffer, reorder_len * data_len bytes */
+	uint8_t 					*reorder_valid;		/*!< Reorder buffer entry holds a frame */
+	uint16_t 					*reorder_seq;		/*!< Sequence number of each entry */
+	uint8_t 					rx_synced;			/*!< First frame is received */
+	uint16_t 					rx_seq;				/*!< Next sequence number to output */
+	uint8_t 					gap;				/*!< Next frame is missing while later ones are buffered */
+	uint32_t 					gap_tick;			/*!< Tick when the gap was seen */
+	nrf24l01_bond_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_bond_t;
+
+static uint8_t *nrf24l01_bond_queue_frame(nrf24l01_bond_handle_t handle, nrf24l01_bond_link_t *link, uint8_t pos)
+{
+	uint8_t idx = (link->head + pos) % handle->queue_len;
+
+	return &link->buf[(uint16_t)idx * handle->packet_len];
+}
+
+static void nrf24l01_bond_queue_pop(nrf24l01_bond_handle_t handle, nrf24l01_bond_link_t *link, uint8_t cnt)
+{
+	link->head = (link->head + cnt) % handle->queue_len;
+	link->count -= cnt;
+	link->in_fifo -= cnt;
+}
+
+static nrf24l01_bond_link_t *nrf24l01_bond_select_link(nrf24l01_bond_handle_t handle)
+{
+	nrf24l01_bond_link_t *best = NULL;
+
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		nrf24l01_bond_link_t *link = &handle->link[i];
+
+		if (!link->up || (link->count >= handle->queue_len))
+		{
+			continue;
+		}
+
+		if ((best == NULL) || (link->count < best->count))
+		{
+			best = link;
+		}
+	}
+
+	return best;
+}
+
+static void nrf24l01_bond_failover(nrf24l01_bond_handle_t handle, uint8_t radio_idx)
+{
+	nrf24l01_bond_link_t *link = &handle->link[radio_idx];
+
+	link->up = 0;
+	link->down_tick = handle->get_tick();
+	handle->stats.num_failover++;
+
+	/* Unconfirmed frames may be delivered twice, receiver drops duplicates */
+	while (link->count != 0)
+	{
+		nrf24l01_bond_link_t *target = nrf24l01_bond_select_link(handle);
+
+		if (target == NULL)
+		{
+			handle->stats.num_drop += link->count;
+			link->count = 0;
+			break;
+		}
+
+		memcpy(nrf24l01_bond_queue_frame(handle, target, target->count),
+		       nrf24l01_bond_queue_frame(handle, link, 0), handle->packet_len);
+		target->count++;
+
+		link->head = (link->head + 1) % handle->queue_len;
+		link->count--;
+	}
+
+	link->head = 0;
+	link->in_fifo = 0;
+}
+
+static void nrf24l01_bond_process_link(nrf24l01_bond_handle_t handle, uint8_t radio_idx)
+{
+	nrf24l01_handle_t radio = handle->radio[radio_idx];
+	nrf24l01_bond_link_t *link = &handle->link[radio_idx];
+	uint8_t fifo_status;
+	uint8_t num_done;
+
+	if (!link->up)
+	{
+		/* Probe with real traffic, one more failure takes it down again */
+		if ((handle->get_tick() - link->down_tick) >= handle->probe_interval_ms)
+		{
+			link->up = 1;
+			link->fail_cnt = (handle->max_fail > 0) ? (handle->max_fail - 1) : 0;
+		}
+		return;
+	}
+
+	if (nrf24l01_get_tx_done(radio, link->in_fifo, &num_done) != ERR_CODE_SUCCESS)
+	{
+		handle->stats.num_fail[radio_idx]++;
+		link->in_fifo = 0;
+
+		if (++link->fail_cnt >= handle->max_fail)
+		{
+			nrf24l01_bond_failover(handle, radio_idx);
+			return;
+		}
+	}
+	else if (num_done != 0)
+	{
+		link->fail_cnt = 0;
+		nrf24l01_bond_queue_pop(handle, link, num_done);
+	}
+
+	while ((link->in_fifo < link->count) && (link->in_fifo < NRF24L01_TX_FIFO_DEPTH))
+	{
+		nrf24l01_get_fifo_status(radio, &fifo_status);
+		if (fifo_status & NRF24L01_FIFO_STATUS_TX_FULL)
+		{
+			break;
+		}
+
+		nrf24l01_transmit(radio, nrf24l01_bond_queue_frame(handle, link, link->in_fifo));
+		link->in_fifo++;
+		handle->stats.num_tx[radio_idx]++;
+	}
+}
+
+static uint8_t nrf24l01_bond_reorder_ready(nrf24l01_bond_handle_t handle)
+{
+	uint8_t idx = handle->rx_seq % handle->reorder_len;
+
+	return handle->rx_synced && handle->reorder_valid[idx] && (handle->reorder_seq[idx] == handle->rx_seq);
+}
+
+static void nrf24l01_bond_reorder_insert(nrf24l01_bond_handle_t handle)
+{
+	uint16_t seq = handle->frame[0] | (handle->frame[1] << 8);
+
+	if (!handle->rx_synced)
+	{
+		handle->rx_synced = 1;
+		handle->rx_seq = seq;
+	}
+
+	int16_t offset = (int16_t)(seq - handle->rx_seq);
+	if (offset < 0)
+	{
+		handle->stats.num_duplicate++;
+		return;
+	}
+
+	/* Too far ahead, give up the oldest missing frames to make room */
+	while (offset >= handle->reorder_len)
+	{
+		uint8_t idx = handle->rx_seq % handle->reorder_len;
+		if (handle->reorder_valid[idx] && (handle->reorder_seq[idx] == handle->rx_seq))
+		{
+			handle->stats.num_overflow++;
+		}
+		else
+		{
+			handle->stats.num_skip++;
+		}
+		handle->reorder_valid[idx] = 0;
+		handle->rx_seq++;
+		offset--;
+		handle->gap = 0;
+	}
+
+	uint8_t idx = seq % handle->reorder_len;
+	if (handle->reorder_valid[idx] && (handle->reorder_seq[idx] == seq))
+	{
+		handle->stats.num_duplicate++;
+		return;
+	}
+
+	memcpy(&handle->reorder_buf[(uint16_t)idx * handle->data_len], &handle->frame[NRF24L01_BOND_HEADER_LEN], handle->data_len);
+	handle->reorder_seq[idx] = seq;
+	handle->reorder_valid[idx] = 1;
+}
+
+nrf24l01_bond_handle_t nrf24l01_bond_init(void)
+{
+	nrf24l01_bond_handle_t handle = calloc(1, sizeof(nrf24l01_bond_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_bond_set_config(nrf24l01_bond_handle_t handle, nrf24l01_bond_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint8_t i = 0; i < NRF24L01_BOND_MAX_RADIO; i++)
+	{
+		handle->radio[i] = config.radio[i];
+	}
+	handle->num_radio = config.num_radio;
+	handle->queue_len = config.queue_len;
+	handle->reorder_len = config.reorder_len;
+	handle->reorder_timeout_ms = config.reorder_timeout_ms;
+	handle->max_fail = config.max_fail;
+	handle->probe_interval_ms = config.probe_interval_ms;
+	handle->get_tick = config.get_tick;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bond_config(nrf24l01_bond_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->num_radio == 0) || (handle->num_radio > NRF24L01_BOND_MAX_RADIO) ||
+	    (handle->queue_len == 0) || (handle->reorder_len == 0) || (handle->get_tick == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		if (handle->radio[i] == NULL)
+		{
+			return ERR_CODE_NULL_PTR;
+		}
+
+		nrf24l01_get_config(handle->radio[i], &radio_cfg);
+		if ((i != 0) && (radio_cfg.packet_len != handle->packet_len))
+		{
+			return ERR_CODE_FAIL;
+		}
+		handle->packet_len = radio_cfg.packet_len;
+	}
+
+	if (handle->packet_len <= NRF24L01_BOND_HEADER_LEN)
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->data_len = handle->packet_len - NRF24L01_BOND_HEADER_LEN;
+
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		free(handle->link[i].buf);
+		memset(&handle->link[i], 0, sizeof(nrf24l01_bond_link_t));
+
+		handle->link[i].buf = calloc(handle->queue_len, handle->packet_len);
+		if (handle->link[i].buf == NULL)
+		{
+			return ERR_CODE_FAIL;
+		}
+		handle->link[i].up = 1;
+	}
+
+	free(handle->frame);
+	free(handle->reorder_buf);
+	free(handle->reorder_valid);
+	free(handle->reorder_seq);
+
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	handle->reorder_buf = calloc(handle->reorder_len, handle->data_len);
+	handle->reorder_valid = calloc(handle->reorder_len, sizeof(uint8_t));
+	handle->reorder_seq = calloc(handle->reorder_len, sizeof(uint16_t));
+	if ((handle->frame == NULL) || (handle->reorder_buf == NULL) ||
+	    (handle->reorder_valid == NULL) || (handle->reorder_seq == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->tx_seq = 0;
+	handle->rx_synced = 0;
+	handle->gap = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bond_transmit(nrf24l01_bond_handle_t handle, uint8_t *data)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	nrf24l01_bond_link_t *link = nrf24l01_bond_select_link(handle);
+	if (link == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t *frame = nrf24l01_bond_queue_frame(handle, link, link->count);
+	frame[0] = handle->tx_seq & 0xFF;
+	frame[1] = (handle->tx_seq >> 8) & 0xFF;
+	memcpy(&frame[NRF24L01_BOND_HEADER_LEN], data, handle->data_len);
+
+	link->count++;
+	handle->tx_seq++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bond_process(nrf24l01_bond_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		nrf24l01_bond_process_link(handle, i);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bond_receive(nrf24l01_bond_handle_t handle, uint8_t *data, uint8_t *available)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (data == NULL) || (available == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*available = 0;
+
+	/* Stop draining once next frame is ready, the rest waits in RX FIFOs */
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		while (!nrf24l01_bond_reorder_ready(handle) &&
+		       (nrf24l01_try_receive(handle->radio[i], handle->frame) == ERR_CODE_SUCCESS))
+		{
+			nrf24l01_bond_reorder_insert(handle);
+		}
+	}
+
+	if (!handle->rx_synced)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	while (1)
+	{
+		uint8_t idx = handle->rx_seq % handle->reorder_len;
+
+		if (handle->reorder_valid[idx] && (handle->reorder_seq[idx] == handle->rx_seq))
+		{
+			memcpy(data, &handle->reorder_buf[(uint16_t)idx * handle->data_len], handle->data_len);
+			handle->reorder_valid[idx] = 0;
+			handle->rx_seq++;
+			handle->gap = 0;
+			handle->stats.num_rx++;
+			*available = 1;
+
+			return ERR_CODE_SUCCESS;
+		}
+
+		/* Next frame is missing, wait only if a later one is already here */
+		uint8_t later = 0;
+		for (uint8_t i = 0; i < handle->reorder_len; i++)
+		{
+			if (handle->reorder_valid[i])
+			{
+				later = 1;
+				break;
+			}
+		}
+
+		if (!later)
+		{
+			handle->gap = 0;
+			return ERR_CODE_SUCCESS;
+		}
+
+		if (!handle->gap)
+		{
+			handle->gap = 1;
+			handle->gap_tick = handle->get_tick();
+			return ERR_CODE_SUCCESS;
+		}
+
+		if ((handle->get_tick() - handle->gap_tick) < handle->reorder_timeout_ms)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		/* Gap stays open so following missing frames are skipped at once */
+		handle->rx_seq++;
+		handle->stats.num_skip++;
+	}
+}
+
+err_code_t nrf24l01_bond_get_stats(nrf24l01_bond_handle_t handle, nrf24l01_bond_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	stats->link_up = 0;
+	for (uint8_t i = 0; i < handle->num_radio; i++)
+	{
+		if (handle->link[i].up)
+		{
+			stats->link_up |= 1 << i;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,176 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_BOND_H__
+#define __NRF24L01_BOND_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Frames carry a 16-bit sequence number of the logical stream,
+ * 			packet_len - 2 bytes of data remain. All bonded radios must use the
+ * 			same packet length and each one its own channel.
+ */
+#define NRF24L01_BOND_HEADER_LEN 		2
+#define NRF24L01_BOND_MAX_RADIO 		4
+
+/**
+ * @brief   Bonding handle structure.
+ */
+typedef struct nrf24l01_bond* nrf24l01_bond_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio[NRF24L01_BOND_MAX_RADIO];	/*!< Radio handles */
+	uint8_t 					num_radio;			/*!< Number of bonded radios */
+	uint8_t 					queue_len;			/*!< TX queue length of each radio, frames */
+	uint8_t 					reorder_len;		/*!< Reorder buffer length of the receiver, frames */
+	uint32_t 					reorder_timeout_ms;	/*!< Time a missing frame is waited for */
+	uint8_t 					max_fail;			/*!< Consecutive MAX_RT before a link is taken down */
+	uint32_t 					probe_interval_ms;	/*!< Time before a link taken down is tried again */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+} nrf24l01_bond_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_tx[NRF24L01_BOND_MAX_RADIO];	/*!< Frames written to each radio */
+	uint32_t 					num_fail[NRF24L01_BOND_MAX_RADIO];	/*!< MAX_RT on each radio */
+	uint32_t 					num_failover;		/*!< Links taken down */
+	uint32_t 					num_drop;			/*!< Frames dropped on failover, no queue left */
+	uint32_t 					num_rx;				/*!< Frames output in order */
+	uint32_t 					num_duplicate;		/*!< Frames received twice */
+	uint32_t 					num_skip;			/*!< Frames given up by the receiver */
+	uint32_t 					num_overflow;		/*!< Frames received but pushed out of reorder buffer */
+	uint8_t 					link_up;			/*!< Bit mask of links up */
+} nrf24l01_bond_stats_t;
+
+/*
+ * @brief   Initialize bonding layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_bond_handle_t nrf24l01_bond_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bond_set_config(nrf24l01_bond_handle_t handle, nrf24l01_bond_cfg_t config);
+
+/*
+ * @brief   Configure bonding layer to run. TX queues and reorder buffer are
+ * 			allocated here.
+ *
+ * @note 	Radios must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bond_config(nrf24l01_bond_handle_t handle);
+
+/*
+ * @brief   Queue one frame of the logical stream on the link which is up and
+ * 			has the shortest TX queue. Data is written to radios by
+ * 			"nrf24l01_bond_process".
+ *
+ * @param 	handle Handle structure.
+ * @param 	data Data, packet_len - 2 bytes.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, all queues are full or all links are down.
+ */
+err_code_t nrf24l01_bond_transmit(nrf24l01_bond_handle_t handle, uint8_t *data);
+
+/*
+ * @brief   Move TX queues into TX FIFOs and track completion on each radio.
+ * 			After "max_fail" consecutive MAX_RT a link is taken down and its
+ * 			queued frames are moved to the other links.
+ *
+ * @note 	This function should be called periodically on the transmitter.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bond_process(nrf24l01_bond_handle_t handle);
+
+/*
+ * @brief   Drain RX FIFOs of all radios and output next frame of the logical
+ * 			stream in order. A missing frame is skipped after
+ * 			"reorder_timeout_ms" if later frames are already received.
+ * 			RX FIFOs are drained only until next frame is ready, so call this
+ * 			function until no frame is available.
+ *
+ * @param 	handle Handle structure.
+ * @param 	data Output buffer, packet_len - 2 bytes.
+ * @param 	available A frame is written to output buffer.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bond_receive(nrf24l01_bond_handle_t handle, uint8_t *data, uint8_t *available);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bond_get_stats(nrf24l01_bond_handle_t handle, nrf24l01_bond_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_BOND_H__ */
@@ -0,0 +1,556 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_bulk.h"
+
+#define NRF24L01_BULK_TYPE_DATA 		0x01
+#define NRF24L01_BULK_TYPE_BLOCK_END 	0x02
+#define NRF24L01_BULK_TYPE_BITMAP 		0x03
+#define NRF24L01_BULK_TYPE_END 			0x04
+#define NRF24L01_BULK_TYPE_RESULT 		0x05
+
+#define NRF24L01_BULK_BITMAP_LEN 		(NRF24L01_BULK_MAX_BLOCK_FRAME / 8)
+
+#define NRF24L01_BULK_RESULT_OK 		0x00
+#define NRF24L01_BULK_RESULT_FAIL 		0x01
+
+/**
+ * @brief   CRC32 (IEEE 802.3, reflected) lookup table, one entry per nibble.
+ */
+static const uint32_t nrf24l01_bulk_crc32_table[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+	0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+	0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+typedef struct nrf24l01_bulk {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					block_frame;		/*!< Frames per block */
+	uint8_t 					max_retry;			/*!< Unanswered polls of one block before transfer fails */
+	uint32_t 					reply_timeout_ms;	/*!< Time waiting for bitmap or result frame */
+	uint32_t 					linger_ms;			/*!< Time receiver keeps answering after completion */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	nrf24l01_bulk_func_write 	write;				/*!< Function write completed block */
+	nrf24l01_func_delay 		delay;				/*!< Function delay of the radio */
+	uint8_t 					frame[NRF24L01_BULK_PACKET_LEN];	/*!< Frame buffer */
+	uint8_t 					tx_session;			/*!< Session id of current transmitted image */
+	uint8_t 					rx_session;			/*!< Session id of last completed received image */
+	uint8_t 					rx_session_valid;	/*!< A received image has completed */
+	uint8_t 					*block_buf;			/*!< Block buffer of the receiver */
+	nrf24l01_bulk_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_bulk_t;
+
+static uint32_t nrf24l01_bulk_crc32(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		crc ^= data[i];
+		crc = (crc >> 4) ^ nrf24l01_bulk_crc32_table[crc & 0x0F];
+		crc = (crc >> 4) ^ nrf24l01_bulk_crc32_table[crc & 0x0F];
+	}
+
+	return crc;
+}
+
+static void nrf24l01_bulk_put_u32(uint8_t *buf, uint32_t value)
+{
+	buf[0] = value & 0xFF;
+	buf[1] = (value >> 8) & 0xFF;
+	buf[2] = (value >> 16) & 0xFF;
+	buf[3] = (value >> 24) & 0xFF;
+}
+
+static uint32_t nrf24l01_bulk_get_u32(uint8_t *buf)
+{
+	return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static err_code_t nrf24l01_bulk_send_frame(nrf24l01_bulk_handle_t handle)
+{
+	handle->frame[1] = handle->tx_session;
+
+	return nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, handle->reply_timeout_ms);
+}
+
+static err_code_t nrf24l01_bulk_send_reply(nrf24l01_bulk_handle_t handle, uint8_t session)
+{
+	err_code_t err_ret;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	handle->frame[1] = session;
+	err_ret = nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, handle->reply_timeout_ms);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->reply_timeout_ms);
+	}
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	return err_ret;
+}
+
+static err_code_t nrf24l01_bulk_wait_reply(nrf24l01_bulk_handle_t handle, uint8_t type)
+{
+	err_code_t err_ret = ERR_CODE_FAIL;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	uint32_t start = handle->get_tick();
+	while ((handle->get_tick() - start) < handle->reply_timeout_ms)
+	{
+		if (nrf24l01_try_receive(handle->radio, handle->frame) != ERR_CODE_SUCCESS)
+		{
+			handle->delay(1);
+			continue;
+		}
+
+		if (handle->frame[0] != type)
+		{
+			continue;
+		}
+
+		/* Reply of an earlier transfer */
+		if (handle->frame[1] != handle->tx_session)
+		{
+			handle->stats.num_stale++;
+			continue;
+		}
+
+		err_ret = ERR_CODE_SUCCESS;
+		break;
+	}
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	return err_ret;
+}
+
+static err_code_t nrf24l01_bulk_transmit_block(nrf24l01_bulk_handle_t handle, const uint8_t *image, uint32_t len, uint16_t block, uint32_t start, uint32_t timeout_ms)
+{
+	err_code_t err_ret;
+	uint32_t first_frame = (uint32_t)block * handle->block_frame;
+	uint32_t frame_cnt = (len + NRF24L01_BULK_DATA_LEN - 1) / NRF24L01_BULK_DATA_LEN;
+	uint8_t block_cnt = ((frame_cnt - first_frame) > handle->block_frame) ? handle->block_frame : (frame_cnt - first_frame);
+	uint32_t block_offset = first_frame * NRF24L01_BULK_DATA_LEN;
+	uint16_t block_len = ((len - block_offset) > ((uint32_t)block_cnt * NRF24L01_BULK_DATA_LEN)) ?
+	                     (block_cnt * NRF24L01_BULK_DATA_LEN) : (len - block_offset);
+	uint8_t missing[NRF24L01_BULK_BITMAP_LEN] = {0};
+	uint8_t first_round = 1;
+	uint8_t retry = 0;
+
+	for (uint8_t idx = 0; idx < block_cnt; idx++)
+	{
+		missing[idx / 8] |= 1 << (idx % 8);
+	}
+
+	while (1)
+	{
+		if ((handle->get_tick() - start) >= timeout_ms)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		for (uint8_t idx = 0; idx < block_cnt; idx++)
+		{
+			if (!(missing[idx / 8] & (1 << (idx % 8))))
+			{
+				continue;
+			}
+
+			uint32_t offset = block_offset + (uint32_t)idx * NRF24L01_BULK_DATA_LEN;
+			uint8_t data_len = ((len - offset) > NRF24L01_BULK_DATA_LEN) ? NRF24L01_BULK_DATA_LEN : (len - offset);
+
+			handle->frame[0] = NRF24L01_BULK_TYPE_DATA;
+			handle->frame[2] = block & 0xFF;
+			handle->frame[3] = (block >> 8) & 0xFF;
+			handle->frame[4] = idx;
+			memcpy(&handle->frame[NRF24L01_BULK_HEADER_LEN], &image[offset], data_len);
+			memset(&handle->frame[NRF24L01_BULK_HEADER_LEN + data_len], 0, NRF24L01_BULK_DATA_LEN - data_len);
+
+			err_ret = nrf24l01_bulk_send_frame(handle);
+			if (err_ret != ERR_CODE_SUCCESS)
+			{
+				return err_ret;
+			}
+
+			handle->stats.num_data_tx++;
+			if (!first_round)
+			{
+				handle->stats.num_repair_tx++;
+			}
+		}
+		first_round = 0;
+		memset(missing, 0, NRF24L01_BULK_BITMAP_LEN);
+
+		/* Poll for bitmap of the block */
+		memset(handle->frame, 0, NRF24L01_BULK_PACKET_LEN);
+		handle->frame[0] = NRF24L01_BULK_TYPE_BLOCK_END;
+		handle->frame[2] = block & 0xFF;
+		handle->frame[3] = (block >> 8) & 0xFF;
+		handle->frame[4] = block_cnt;
+		handle->frame[5] = block_len & 0xFF;
+		handle->frame[6] = (block_len >> 8) & 0xFF;
+
+		err_ret = nrf24l01_bulk_send_frame(handle);
+		if (err_ret == ERR_CODE_SUCCESS)
+		{
+			err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->reply_timeout_ms);
+		}
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+		handle->stats.num_poll_tx++;
+
+		if (nrf24l01_bulk_wait_reply(handle, NRF24L01_BULK_TYPE_BITMAP) != ERR_CODE_SUCCESS)
+		{
+			handle->stats.num_poll_timeout++;
+			if (++retry > handle->max_retry)
+			{
+				return ERR_CODE_FAIL;
+			}
+			continue;
+		}
+		retry = 0;
+
+		uint16_t reply_block = handle->frame[2] | (handle->frame[3] << 8);
+		if ((reply_block > block) || ((reply_block == block) && handle->frame[4]))
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		if (reply_block == block)
+		{
+			for (uint8_t idx = 0; idx < block_cnt; idx++)
+			{
+				if (!(handle->frame[5 + idx / 8] & (1 << (idx % 8))))
+				{
+					missing[idx / 8] |= 1 << (idx % 8);
+				}
+			}
+		}
+	}
+}
+
+nrf24l01_bulk_handle_t nrf24l01_bulk_init(void)
+{
+	nrf24l01_bulk_handle_t handle = calloc(1, sizeof(nrf24l01_bulk_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_bulk_set_config(nrf24l01_bulk_handle_t handle, nrf24l01_bulk_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->block_frame = config.block_frame;
+	handle->max_retry = config.max_retry;
+	handle->reply_timeout_ms = config.reply_timeout_ms;
+	handle->linger_ms = config.linger_ms;
+	handle->get_tick = config.get_tick;
+	handle->write = config.write;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bulk_config(nrf24l01_bulk_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->block_frame == 0) || (handle->block_frame > NRF24L01_BULK_MAX_BLOCK_FRAME) ||
+	    (handle->get_tick == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if ((radio_cfg.packet_len != NRF24L01_BULK_PACKET_LEN) || (radio_cfg.delay == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->delay = radio_cfg.delay;
+
+	free(handle->block_buf);
+	handle->block_buf = calloc(handle->block_frame, NRF24L01_BULK_DATA_LEN);
+	if (handle->block_buf == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bulk_transmit(nrf24l01_bulk_handle_t handle, const uint8_t *image, uint32_t len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || ((image == NULL) && (len != 0)))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint32_t frame_cnt = (len + NRF24L01_BULK_DATA_LEN - 1) / NRF24L01_BULK_DATA_LEN;
+	uint32_t block_cnt = (frame_cnt + handle->block_frame - 1) / handle->block_frame;
+	if (block_cnt > 0xFFFF)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret;
+	uint32_t start = handle->get_tick();
+
+	handle->tx_session++;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	for (uint32_t block = 0; block < block_cnt; block++)
+	{
+		err_ret = nrf24l01_bulk_transmit_block(handle, image, len, block, start, timeout_ms);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+	}
+
+	/* Image length and CRC32 are verified by the receiver */
+	uint32_t crc = nrf24l01_bulk_crc32(0xFFFFFFFF, image, len) ^ 0xFFFFFFFF;
+
+	for (uint8_t retry = 0; retry <= handle->max_retry; retry++)
+	{
+		memset(handle->frame, 0, NRF24L01_BULK_PACKET_LEN);
+		handle->frame[0] = NRF24L01_BULK_TYPE_END;
+		nrf24l01_bulk_put_u32(&handle->frame[2], len);
+		nrf24l01_bulk_put_u32(&handle->frame[6], crc);
+
+		err_ret = nrf24l01_bulk_send_frame(handle);
+		if (err_ret == ERR_CODE_SUCCESS)
+		{
+			err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->reply_timeout_ms);
+		}
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+
+		if (nrf24l01_bulk_wait_reply(handle, NRF24L01_BULK_TYPE_RESULT) == ERR_CODE_SUCCESS)
+		{
+			return (handle->frame[2] == NRF24L01_BULK_RESULT_OK) ? ERR_CODE_SUCCESS : ERR_CODE_FAIL;
+		}
+	}
+
+	return ERR_CODE_FAIL;
+}
+
+err_code_t nrf24l01_bulk_receive(nrf24l01_bulk_handle_t handle, uint32_t *len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->write == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t bitmap[NRF24L01_BULK_BITMAP_LEN] = {0};
+	uint16_t cur_block = 0;
+	uint32_t written = 0;
+	uint32_t crc = 0xFFFFFFFF;
+	uint8_t session = 0;
+	uint8_t synced = 0;
+	uint8_t complete = 0;
+	uint32_t start = handle->get_tick();
+	uint32_t complete_tick = 0;
+
+	*len = 0;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	while (1)
+	{
+		uint32_t now = handle->get_tick();
+		if (complete)
+		{
+			if ((now - complete_tick) >= handle->linger_ms)
+			{
+				handle->rx_session = session;
+				handle->rx_session_valid = 1;
+				*len = written;
+				return ERR_CODE_SUCCESS;
+			}
+		}
+		else if ((now - start) >= timeout_ms)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (nrf24l01_try_receive(handle->radio, handle->frame) != ERR_CODE_SUCCESS)
+		{
+			handle->delay(1);
+			continue;
+		}
+
+		/* Lock on the first new session, drop frames of other transfers */
+		if (!synced)
+		{
+			if (handle->rx_session_valid && (handle->frame[1] == handle->rx_session))
+			{
+				handle->stats.num_stale++;
+				continue;
+			}
+
+			session = handle->frame[1];
+			synced = 1;
+		}
+		else if (handle->frame[1] != session)
+		{
+			handle->stats.num_stale++;
+			continue;
+		}
+
+		uint16_t block = handle->frame[2] | (handle->frame[3] << 8);
+
+		switch (handle->frame[0])
+		{
+		case NRF24L01_BULK_TYPE_DATA:
+		{
+			uint8_t idx = handle->frame[4];
+
+			if (!complete && (block == cur_block) && (idx < handle->block_frame))
+			{
+				memcpy(&handle->block_buf[(uint32_t)idx * NRF24L01_BULK_DATA_LEN],
+				       &handle->frame[NRF24L01_BULK_HEADER_LEN], NRF24L01_BULK_DATA_LEN);
+				bitmap[idx / 8] |= 1 << (idx % 8);
+			}
+			break;
+		}
+
+		case NRF24L01_BULK_TYPE_BLOCK_END:
+		{
+			uint8_t block_cnt = handle->frame[4];
+			uint16_t block_len = handle->frame[5] | (handle->frame[6] << 8);
+			uint8_t block_complete = 1;
+
+			if (block < cur_block)
+			{
+				/* Bitmap of a completed block was lost */
+				block_complete = 1;
+			}
+			else if (!complete && (block == cur_block) && (block_cnt <= handle->block_frame) &&
+			         (block_len <= ((uint32_t)block_cnt * NRF24L01_BULK_DATA_LEN)))
+			{
+				for (uint8_t idx = 0; idx < block_cnt; idx++)
+				{
+					if (!(bitmap[idx / 8] & (1 << (idx % 8))))
+					{
+						block_complete = 0;
+						break;
+					}
+				}
+
+				if (block_complete)
+				{
+					if (handle->write(written, handle->block_buf, block_len) != ERR_CODE_SUCCESS)
+					{
+						return ERR_CODE_FAIL;
+					}
+
+					crc = nrf24l01_bulk_crc32(crc, handle->block_buf, block_len);
+					written += block_len;
+					cur_block++;
+					memset(bitmap, 0, NRF24L01_BULK_BITMAP_LEN);
+				}
+			}
+			else
+			{
+				break;
+			}
+
+			memset(handle->frame, 0, NRF24L01_BULK_PACKET_LEN);
+			handle->frame[0] = NRF24L01_BULK_TYPE_BITMAP;
+			handle->frame[2] = block & 0xFF;
+			handle->frame[3] = (block >> 8) & 0xFF;
+			handle->frame[4] = block_complete;
+			if (block_complete)
+			{
+				memset(&handle->frame[5], 0xFF, NRF24L01_BULK_BITMAP_LEN);
+			}
+			else
+			{
+				memcpy(&handle->frame[5], bitmap, NRF24L01_BULK_BITMAP_LEN);
+			}
+
+			nrf24l01_bulk_send_reply(handle, session);
+			break;
+		}
+
+		case NRF24L01_BULK_TYPE_END:
+		{
+			uint32_t image_len = nrf24l01_bulk_get_u32(&handle->frame[2]);
+			uint32_t image_crc = nrf24l01_bulk_get_u32(&handle->frame[6]);
+			uint8_t result = NRF24L01_BULK_RESULT_OK;
+
+			if (!complete)
+			{
+				if ((image_len != written) || (image_crc != (crc ^ 0xFFFFFFFF)))
+				{
+					result = NRF24L01_BULK_RESULT_FAIL;
+				}
+			}
+
+			memset(handle->frame, 0, NRF24L01_BULK_PACKET_LEN);
+			handle->frame[0] = NRF24L01_BULK_TYPE_RESULT;
+			handle->frame[2] = result;
+
+			nrf24l01_bulk_send_reply(handle, session);
+
+			if (result != NRF24L01_BULK_RESULT_OK)
+			{
+				return ERR_CODE_FAIL;
+			}
+
+			if (!complete)
+			{
+				complete = 1;
+				complete_tick = handle->get_tick();
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bulk_get_stats(nrf24l01_bulk_handle_t handle, nrf24l01_bulk_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
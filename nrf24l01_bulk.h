@@ -0,0 +1,172 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_BULK_H__
+#define __NRF24L01_BULK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Bulk transfer uses fixed 32 bytes frames. DATA frame carries type,
+ * 			session id, block number and frame index in block, 27 bytes of
+ * 			data remain. Receiver reports missing frames of a block with a
+ * 			128-bit bitmap. Session id changes on each transfer, so frames left
+ * 			from an earlier transfer are dropped.
+ */
+#define NRF24L01_BULK_PACKET_LEN 		32
+#define NRF24L01_BULK_HEADER_LEN 		5
+#define NRF24L01_BULK_DATA_LEN 			(NRF24L01_BULK_PACKET_LEN - NRF24L01_BULK_HEADER_LEN)
+#define NRF24L01_BULK_MAX_BLOCK_FRAME 	128
+
+typedef err_code_t (*nrf24l01_bulk_func_write)(uint32_t offset, uint8_t *data, uint16_t len);
+
+/**
+ * @brief   Bulk transfer handle structure.
+ */
+typedef struct nrf24l01_bulk* nrf24l01_bulk_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ *
+ * @note 	On the receiver "block_frame" only bounds the block buffer, block
+ * 			length is sent by the sender at the end of each block. Sender must
+ * 			use the same or a smaller value, frames beyond the receiver buffer
+ * 			are never acknowledged and the sender times out.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					block_frame;		/*!< Frames per block, 1 to 128 */
+	uint8_t 					max_retry;			/*!< Unanswered polls of one block before transfer fails */
+	uint32_t 					reply_timeout_ms;	/*!< Time waiting for bitmap or result frame */
+	uint32_t 					linger_ms;			/*!< Time receiver keeps answering after completion */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	nrf24l01_bulk_func_write 	write;				/*!< Function write completed block, receiver only */
+} nrf24l01_bulk_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_data_tx;		/*!< DATA frames transmitted */
+	uint32_t 					num_repair_tx;		/*!< DATA frames retransmitted after bitmap */
+	uint32_t 					num_poll_tx;		/*!< Block end polls transmitted */
+	uint32_t 					num_poll_timeout;	/*!< Block end polls without reply */
+	uint32_t 					num_stale;			/*!< Frames of another session dropped */
+} nrf24l01_bulk_stats_t;
+
+/*
+ * @brief   Initialize bulk transfer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_bulk_handle_t nrf24l01_bulk_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bulk_set_config(nrf24l01_bulk_handle_t handle, nrf24l01_bulk_cfg_t config);
+
+/*
+ * @brief   Configure bulk transfer to run. Block buffer of the receiver is
+ * 			allocated here.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before with packet
+ * 			length 32 and function "delay" assigned.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bulk_config(nrf24l01_bulk_handle_t handle);
+
+/*
+ * @brief   Transmit image. Each block is sent as a burst of no-ACK frames
+ * 			keeping TX FIFO full, then polled. Frames missing in the returned
+ * 			bitmap are sent again until the block is complete. At the end, image
+ * 			length and CRC32 are sent and checked by the receiver.
+ *
+ * @note 	Radio is switched between TX and RX mode and left in TX mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	image Image buffer.
+ * @param 	len Image length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bulk_transmit(nrf24l01_bulk_handle_t handle, const uint8_t *image, uint32_t len, uint32_t timeout_ms);
+
+/*
+ * @brief   Receive image. Each completed block is passed to function "write"
+ * 			in order. Function succeeds only if image length and CRC32 match.
+ *
+ * @note 	Radio is switched between RX and TX mode and left in RX mode.
+ *
+ * @param 	handle Handle structure.
+ * @param 	len Image length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bulk_receive(nrf24l01_bulk_handle_t handle, uint32_t *len, uint32_t timeout_ms);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bulk_get_stats(nrf24l01_bulk_handle_t handle, nrf24l01_bulk_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_BULK_H__ */
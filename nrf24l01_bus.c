@@ -0,0 +1,161 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_bus.h"
+
+typedef struct nrf24l01_bus {
+	nrf24l01_bus_func_lock 		lock;				/*!< Function lock bus */
+	nrf24l01_bus_func_unlock 	unlock;				/*!< Function unlock bus */
+	nrf24l01_bus_func_try_lock 	try_lock;			/*!< Function lock bus without waiting */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+	uint32_t 					lock_time;			/*!< Time when bus was locked */
+	uint32_t 					last_time;			/*!< Time when elapsed_us was last updated */
+	nrf24l01_bus_stats_t 		stats;				/*!< Statistics, updated while bus is held */
+} nrf24l01_bus_t;
+
+nrf24l01_bus_handle_t nrf24l01_bus_init(void)
+{
+	nrf24l01_bus_handle_t handle = calloc(1, sizeof(nrf24l01_bus_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_bus_set_config(nrf24l01_bus_handle_t handle, nrf24l01_bus_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->lock = config.lock;
+	handle->unlock = config.unlock;
+	handle->try_lock = config.try_lock;
+	handle->get_time_us = config.get_time_us;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bus_config(nrf24l01_bus_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->lock == NULL) || (handle->unlock == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	memset(&handle->stats, 0, sizeof(nrf24l01_bus_stats_t));
+	if (handle->get_time_us != NULL)
+	{
+		handle->last_time = handle->get_time_us();
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bus_acquire(nrf24l01_bus_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t contention = 0;
+
+	if ((handle->try_lock == NULL) || (handle->try_lock() != ERR_CODE_SUCCESS))
+	{
+		contention = (handle->try_lock != NULL);
+		handle->lock();
+	}
+
+	if (contention)
+	{
+		handle->stats.num_contention++;
+	}
+
+	if (handle->get_time_us != NULL)
+	{
+		handle->lock_time = handle->get_time_us();
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bus_release(nrf24l01_bus_handle_t handle, uint32_t num_byte)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->stats.num_transaction++;
+	handle->stats.num_byte += num_byte;
+
+	if (handle->get_time_us != NULL)
+	{
+		/* Differences of 32-bit time are added up in 64 bits so that totals
+		 * do not wrap */
+		uint32_t now = handle->get_time_us();
+
+		handle->stats.busy_us += (uint32_t)(now - handle->lock_time);
+		handle->stats.elapsed_us += (uint32_t)(now - handle->last_time);
+		handle->last_time = now;
+	}
+
+	return handle->unlock();
+}
+
+err_code_t nrf24l01_bus_get_stats(nrf24l01_bus_handle_t handle, nrf24l01_bus_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Statistics only, read without the bus lock so that this function is
+	 * safe inside a batch */
+	*stats = handle->stats;
+
+	if (handle->get_time_us != NULL)
+	{
+		stats->elapsed_us += (uint32_t)(handle->get_time_us() - handle->last_time);
+		if (stats->elapsed_us != 0)
+		{
+			stats->utilization = (stats->busy_us * 1000) / stats->elapsed_us;
+		}
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_bus_reset_stats(nrf24l01_bus_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->lock();
+
+	memset(&handle->stats, 0, sizeof(nrf24l01_bus_stats_t));
+	if (handle->get_time_us != NULL)
+	{
+		handle->last_time = handle->get_time_us();
+	}
+
+	handle->unlock();
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,161 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_BUS_H__
+#define __NRF24L01_BUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+typedef err_code_t (*nrf24l01_bus_func_lock)(void);
+typedef err_code_t (*nrf24l01_bus_func_unlock)(void);
+typedef err_code_t (*nrf24l01_bus_func_try_lock)(void);
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_bus_func_lock 		lock;				/*!< Function lock bus, e.g. take mutex */
+	nrf24l01_bus_func_unlock 	unlock;				/*!< Function unlock bus, e.g. give mutex */
+	nrf24l01_bus_func_try_lock 	try_lock;			/*!< Function lock bus without waiting, optional */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us, optional */
+} nrf24l01_bus_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_transaction;	/*!< Transactions, a batch counts as one */
+	uint32_t 					num_byte;			/*!< Bytes transferred */
+	uint32_t 					num_contention;		/*!< Transactions which waited for the bus */
+	uint64_t 					busy_us;			/*!< Time bus is held */
+	uint64_t 					elapsed_us;			/*!< Time since statistics are reset */
+	uint16_t 					utilization;		/*!< busy_us / elapsed_us in per mille */
+} nrf24l01_bus_stats_t;
+
+/*
+ * @brief   Initialize shared SPI bus.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_bus_handle_t nrf24l01_bus_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_set_config(nrf24l01_bus_handle_t handle, nrf24l01_bus_cfg_t config);
+
+/*
+ * @brief   Configure shared SPI bus to run. Radios are attached to the bus by
+ * 			fields "bus", "bus_acquire" and "bus_release" of their configuration
+ * 			structure, set to this handle, "nrf24l01_bus_acquire" and
+ * 			"nrf24l01_bus_release".
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_config(nrf24l01_bus_handle_t handle);
+
+/*
+ * @brief   Lock the bus for one transaction or one batch.
+ *
+ * @note 	Called by the radio driver around each chip select cycle.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_acquire(nrf24l01_bus_handle_t handle);
+
+/*
+ * @brief   Account transferred bytes and unlock the bus.
+ *
+ * @note 	Called by the radio driver around each chip select cycle.
+ *
+ * @param 	handle Handle structure.
+ * @param 	num_byte Bytes transferred while the bus was held.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_release(nrf24l01_bus_handle_t handle, uint32_t num_byte);
+
+/*
+ * @brief   Get statistics. The bus is not locked, so the values may be one
+ * 			transaction apart from each other.
+ *
+ * @note 	Times are accumulated in 64 bits at each transaction, so they do
+ * 			not wrap as long as the bus is used at least once per wrap period
+ * 			of "get_time_us", about 71 minutes.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_get_stats(nrf24l01_bus_handle_t handle, nrf24l01_bus_stats_t *stats);
+
+/*
+ * @brief   Reset statistics.
+ *
+ * @note 	The bus is locked while statistics are reset. Do not call this
+ * 			function between "nrf24l01_begin_batch" and "nrf24l01_end_batch"
+ * 			unless function "lock" is recursive.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_bus_reset_stats(nrf24l01_bus_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_BUS_H__ */
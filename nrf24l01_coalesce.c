@@ -0,0 +1,232 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_coalesce.h"
+
+typedef struct nrf24l01_coalesce {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint32_t 					deadline_ms;		/*!< Pending frame deadline */
+	uint32_t 					tx_timeout_ms;		/*!< Timeout of one frame transmission */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					frame_len;			/*!< Bytes used in pending frame */
+	uint32_t 					first_tick;			/*!< Tick of first message in pending frame */
+	uint8_t 					*frame;				/*!< Pending frame, packet_len bytes */
+	nrf24l01_coalesce_stats_t 	stats;				/*!< Statistics */
+} nrf24l01_coalesce_t;
+
+nrf24l01_coalesce_handle_t nrf24l01_coalesce_init(void)
+{
+	nrf24l01_coalesce_handle_t handle = calloc(1, sizeof(nrf24l01_coalesce_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_coalesce_set_config(nrf24l01_coalesce_handle_t handle, nrf24l01_coalesce_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->deadline_ms = config.deadline_ms;
+	handle->tx_timeout_ms = config.tx_timeout_ms;
+	handle->get_tick = config.get_tick;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_coalesce_config(nrf24l01_coalesce_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->get_tick == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if (radio_cfg.packet_len <= NRF24L01_COALESCE_LEN_SIZE)
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+
+	free(handle->frame);
+
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	if (handle->frame == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->frame_len = 0;
+	memset(&handle->stats, 0, sizeof(nrf24l01_coalesce_stats_t));
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_coalesce_flush(nrf24l01_coalesce_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->frame_len == 0)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Zero padding ends the message list */
+	memset(&handle->frame[handle->frame_len], 0, handle->packet_len - handle->frame_len);
+
+	/* Failed frame stays pending and is sent again by next flush */
+	err_code_t err_ret = nrf24l01_transmit_pipelined(handle->radio, handle->frame, handle->tx_timeout_ms);
+	if (err_ret != ERR_CODE_SUCCESS)
+	{
+		handle->stats.num_tx_fail++;
+		return err_ret;
+	}
+
+	handle->frame_len = 0;
+	handle->stats.num_frame++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_coalesce_transmit(nrf24l01_coalesce_handle_t handle, uint8_t *msg, uint8_t msg_len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (msg == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((msg_len == 0) || (msg_len > (handle->packet_len - NRF24L01_COALESCE_LEN_SIZE)))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret;
+
+	if ((handle->frame_len + NRF24L01_COALESCE_LEN_SIZE + msg_len) > handle->packet_len)
+	{
+		err_ret = nrf24l01_coalesce_flush(handle);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+	}
+
+	if (handle->frame_len == 0)
+	{
+		handle->first_tick = handle->get_tick();
+	}
+
+	handle->frame[handle->frame_len] = msg_len;
+	memcpy(&handle->frame[handle->frame_len + NRF24L01_COALESCE_LEN_SIZE], msg, msg_len);
+	handle->frame_len += NRF24L01_COALESCE_LEN_SIZE + msg_len;
+	handle->stats.num_msg++;
+
+	/* No room for another message, a failure is reported by next flush */
+	if ((handle->frame_len + NRF24L01_COALESCE_LEN_SIZE) >= handle->packet_len)
+	{
+		nrf24l01_coalesce_flush(handle);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_coalesce_process(nrf24l01_coalesce_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->frame_len == 0)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	if ((handle->get_tick() - handle->first_tick) < handle->deadline_ms)
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	err_code_t err_ret = nrf24l01_coalesce_flush(handle);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		handle->stats.num_deadline++;
+	}
+
+	return err_ret;
+}
+
+err_code_t nrf24l01_coalesce_receive(nrf24l01_coalesce_handle_t handle, const uint8_t *rx_payload, nrf24l01_coalesce_msg_t *msg, uint8_t max_msg, uint8_t *num_msg)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (rx_payload == NULL) || (msg == NULL) || (num_msg == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t offset = 0;
+
+	*num_msg = 0;
+
+	while (offset < handle->packet_len)
+	{
+		uint8_t len = rx_payload[offset];
+
+		if (len == 0)
+		{
+			break;
+		}
+
+		if ((offset + NRF24L01_COALESCE_LEN_SIZE + len) > handle->packet_len)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		if (*num_msg >= max_msg)
+		{
+			return ERR_CODE_FAIL;
+		}
+
+		msg[*num_msg].data = &rx_payload[offset + NRF24L01_COALESCE_LEN_SIZE];
+		msg[*num_msg].len = len;
+		(*num_msg)++;
+
+		offset += NRF24L01_COALESCE_LEN_SIZE + len;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_coalesce_get_stats(nrf24l01_coalesce_handle_t handle, nrf24l01_coalesce_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,185 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_COALESCE_H__
+#define __NRF24L01_COALESCE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Each message in a frame is stored as one length byte followed by
+ * 			the data. A zero length byte, or the end of the frame, ends the
+ * 			list, so a message carries at most packet_len - 1 bytes.
+ */
+#define NRF24L01_COALESCE_LEN_SIZE 		1
+
+/**
+ * @brief   Coalescing handle structure.
+ */
+typedef struct nrf24l01_coalesce* nrf24l01_coalesce_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint32_t 					deadline_ms;		/*!< Pending frame is sent at most this time after its first message */
+	uint32_t 					tx_timeout_ms;		/*!< Timeout of one frame transmission */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+} nrf24l01_coalesce_cfg_t;
+
+/**
+ * @brief   Received message. Data points into the received frame.
+ */
+typedef struct {
+	const uint8_t 				*data;				/*!< Message data */
+	uint8_t 					len;				/*!< Message length */
+} nrf24l01_coalesce_msg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_msg;			/*!< Messages queued */
+	uint32_t 					num_frame;			/*!< Frames sent */
+	uint32_t 					num_deadline;		/*!< Frames sent because of deadline */
+	uint32_t 					num_tx_fail;		/*!< Frame transmissions failed, frame kept pending */
+} nrf24l01_coalesce_stats_t;
+
+/*
+ * @brief   Initialize coalescing layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_coalesce_handle_t nrf24l01_coalesce_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_coalesce_set_config(nrf24l01_coalesce_handle_t handle, nrf24l01_coalesce_cfg_t config);
+
+/*
+ * @brief   Configure coalescing layer to run.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_coalesce_config(nrf24l01_coalesce_handle_t handle);
+
+/*
+ * @brief   Add one message to the pending frame. The pending frame is sent
+ * 			first if the message does not fit, and right after if no other
+ * 			message fits.
+ *
+ * @note 	If the pending frame cannot be sent, it is kept and sent again by
+ * 			next flush. A frame which is full and still pending makes this
+ * 			function fail until it is sent.
+ *
+ * @param 	handle Handle structure.
+ * @param 	msg Message.
+ * @param 	msg_len Message length, 1 to packet_len - 1.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success, message is queued.
+ *      - Others:           Fail, message is not queued.
+ */
+err_code_t nrf24l01_coalesce_transmit(nrf24l01_coalesce_handle_t handle, uint8_t *msg, uint8_t msg_len);
+
+/*
+ * @brief   Send the pending frame if its deadline has passed. Call this
+ * 			function periodically.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_coalesce_process(nrf24l01_coalesce_handle_t handle);
+
+/*
+ * @brief   Send the pending frame now.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, frame is kept pending.
+ */
+err_code_t nrf24l01_coalesce_flush(nrf24l01_coalesce_handle_t handle);
+
+/*
+ * @brief   Split a received frame into messages. No data is copied, each
+ * 			message points into rx_payload.
+ *
+ * @param 	handle Handle structure.
+ * @param 	rx_payload Received frame.
+ * @param 	msg Message list.
+ * @param 	max_msg Size of message list.
+ * @param 	num_msg Number of messages.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, frame is malformed or list is too short.
+ */
+err_code_t nrf24l01_coalesce_receive(nrf24l01_coalesce_handle_t handle, const uint8_t *rx_payload, nrf24l01_coalesce_msg_t *msg, uint8_t max_msg, uint8_t *num_msg);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_coalesce_get_stats(nrf24l01_coalesce_handle_t handle, nrf24l01_coalesce_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_COALESCE_H__ */
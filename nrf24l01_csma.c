@@ -0,0 +1,204 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_csma.h"
+
+#define NRF24L01_CSMA_MAX_BE 			15
+
+typedef struct nrf24l01_csma {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					slot_us;			/*!< Backoff slot time in us */
+	uint8_t 					min_be;				/*!< Initial backoff exponent */
+	uint8_t 					max_be;				/*!< Maximum backoff exponent */
+	uint8_t 					max_attempt;		/*!< Channel access attempts per packet */
+	uint32_t 					seed;				/*!< Random seed */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+	nrf24l01_func_delay 		delay;				/*!< Function delay in ms */
+	uint32_t 					rand_state;			/*!< Random generator state */
+	uint32_t 					backoff_us;			/*!< Backoff time below 1 ms, not yet in stats */
+	nrf24l01_csma_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_csma_t;
+
+static uint32_t nrf24l01_csma_rand(nrf24l01_csma_handle_t handle)
+{
+	/* Xorshift32 */
+	uint32_t x = handle->rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	handle->rand_state = x;
+
+	return x;
+}
+
+static void nrf24l01_csma_wait_us(nrf24l01_csma_handle_t handle, uint32_t time_us)
+{
+	if ((handle->delay != NULL) && (time_us >= 1000))
+	{
+		handle->delay(time_us / 1000);
+		time_us %= 1000;
+	}
+
+	uint32_t start = handle->get_time_us();
+	while ((handle->get_time_us() - start) < time_us);
+}
+
+static void nrf24l01_csma_backoff(nrf24l01_csma_handle_t handle, uint8_t be)
+{
+	uint32_t slot_cnt = nrf24l01_csma_rand(handle) & ((1UL << be) - 1);
+	uint32_t time_us = slot_cnt * handle->slot_us;
+
+	nrf24l01_csma_wait_us(handle, time_us);
+
+	handle->stats.num_backoff++;
+	handle->backoff_us += time_us;
+	handle->stats.backoff_ms += handle->backoff_us / 1000;
+	handle->backoff_us %= 1000;
+}
+
+nrf24l01_csma_handle_t nrf24l01_csma_init(void)
+{
+	nrf24l01_csma_handle_t handle = calloc(1, sizeof(nrf24l01_csma_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_csma_set_config(nrf24l01_csma_handle_t handle, nrf24l01_csma_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->slot_us = config.slot_us;
+	handle->min_be = config.min_be;
+	handle->max_be = config.max_be;
+	handle->max_attempt = config.max_attempt;
+	handle->seed = config.seed;
+	handle->get_time_us = config.get_time_us;
+	handle->delay = config.delay;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_csma_config(nrf24l01_csma_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->get_time_us == NULL) || (handle->max_attempt == 0) ||
+	    (handle->max_be > NRF24L01_CSMA_MAX_BE) || (handle->min_be > handle->max_be))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->rand_state = (handle->seed != 0) ? handle->seed : handle->get_time_us();
+	if (handle->rand_state == 0)
+	{
+		handle->rand_state = 1;
+	}
+
+	handle->backoff_us = 0;
+	memset(&handle->stats, 0, sizeof(nrf24l01_csma_stats_t));
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_csma_sense(nrf24l01_csma_handle_t handle, uint8_t *busy)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (busy == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* One CONFIG write each way plus one RPD read */
+	nrf24l01_set_prim_rx(handle->radio, 1);
+
+	nrf24l01_csma_wait_us(handle, NRF24L01_CSMA_SENSE_TIME_US);
+
+	/* RPD is latched when leaving RX, read it before switching back */
+	nrf24l01_get_rpd(handle->radio, busy);
+
+	return nrf24l01_set_prim_rx(handle->radio, 0);
+}
+
+err_code_t nrf24l01_csma_transmit(nrf24l01_csma_handle_t handle, uint8_t *tx_payload, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (tx_payload == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	err_code_t err_ret;
+	uint8_t busy;
+	uint8_t be = handle->min_be;
+
+	for (uint8_t attempt = 0; attempt < handle->max_attempt; attempt++)
+	{
+		if (attempt != 0)
+		{
+			nrf24l01_csma_backoff(handle, be);
+			if (be < handle->max_be)
+			{
+				be++;
+			}
+		}
+
+		handle->stats.num_attempt++;
+
+		err_ret = nrf24l01_csma_sense(handle, &busy);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+
+		if (busy)
+		{
+			handle->stats.num_busy++;
+			continue;
+		}
+
+		err_ret = nrf24l01_transmit_pipelined(handle->radio, tx_payload, timeout_ms);
+		if (err_ret == ERR_CODE_SUCCESS)
+		{
+			err_ret = nrf24l01_wait_tx_complete(handle->radio, timeout_ms);
+		}
+
+		if (err_ret == ERR_CODE_SUCCESS)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		/* Not acknowledged, most likely a collision */
+		nrf24l01_flush_tx_fifo(handle->radio);
+		handle->stats.num_collision++;
+	}
+
+	handle->stats.num_fail++;
+
+	return ERR_CODE_FAIL;
+}
+
+err_code_t nrf24l01_csma_get_stats(nrf24l01_csma_handle_t handle, nrf24l01_csma_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
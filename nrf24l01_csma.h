@@ -0,0 +1,160 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_CSMA_H__
+#define __NRF24L01_CSMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Time in RX mode before RPD is valid, 130 us settling plus 40 us
+ * 			detection.
+ */
+#define NRF24L01_CSMA_SENSE_TIME_US 	170
+
+/**
+ * @brief   CSMA handle structure.
+ */
+typedef struct nrf24l01_csma* nrf24l01_csma_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					slot_us;			/*!< Backoff slot time in us */
+	uint8_t 					min_be;				/*!< Initial backoff exponent */
+	uint8_t 					max_be;				/*!< Maximum backoff exponent, up to 15 */
+	uint8_t 					max_attempt;		/*!< Channel access attempts per packet */
+	uint32_t 					seed;				/*!< Random seed, 0 to seed from time */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+	nrf24l01_func_delay 		delay;				/*!< Function delay in ms, optional, for long backoff */
+} nrf24l01_csma_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_attempt;		/*!< Channel access attempts */
+	uint32_t 					num_busy;			/*!< Attempts found channel busy */
+	uint32_t 					num_collision;		/*!< Packets sent but not acknowledged */
+	uint32_t 					num_backoff;		/*!< Backoffs */
+	uint32_t 					backoff_ms;			/*!< Total backoff time in ms */
+	uint32_t 					num_fail;			/*!< Packets dropped after max_attempt */
+} nrf24l01_csma_stats_t;
+
+/*
+ * @brief   Initialize CSMA layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_csma_handle_t nrf24l01_csma_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_csma_set_config(nrf24l01_csma_handle_t handle, nrf24l01_csma_cfg_t config);
+
+/*
+ * @brief   Configure CSMA layer to run.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before. A small ARC set
+ * 			by "nrf24l01_set_auto_retransmit" leaves recovery from collisions to
+ * 			the random backoff instead of the fixed retransmit delay.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_csma_config(nrf24l01_csma_handle_t handle);
+
+/*
+ * @brief   Check if the channel is busy. The radio is switched to RX mode for
+ * 			NRF24L01_CSMA_SENSE_TIME_US, RPD is read and the radio is switched
+ * 			back to TX mode. This costs three 2-byte SPI transactions: CONFIG
+ * 			write, RPD read and CONFIG write.
+ *
+ * @param 	handle Handle structure.
+ * @param 	busy Channel is busy.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_csma_sense(nrf24l01_csma_handle_t handle, uint8_t *busy);
+
+/*
+ * @brief   Transmit one packet after the channel is found idle. When the
+ * 			channel is busy or the packet is not acknowledged, wait a random
+ * 			number of slots between 0 and 2^BE - 1 and try again, BE grows by
+ * 			one after each try up to max_be.
+ *
+ * @note 	TX FIFO must be empty, the packet is complete when this function
+ * 			returns.
+ *
+ * @param 	handle Handle structure.
+ * @param 	tx_payload Transmit buffer.
+ * @param 	timeout_ms Timeout of each transmission in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_csma_transmit(nrf24l01_csma_handle_t handle, uint8_t *tx_payload, uint32_t timeout_ms);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_csma_get_stats(nrf24l01_csma_handle_t handle, nrf24l01_csma_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_CSMA_H__ */
@@ -0,0 +1,514 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_fec.h"
+
+#define NRF24L01_FEC_GF_POLY 			0x11D
+
+/**
+ * @brief   GF(256) exponent and logarithm tables, exponent table is doubled so
+ * 			that the sum of two logarithms needs no modulo.
+ */
+static uint8_t nrf24l01_fec_gf_exp[512];
+static uint8_t nrf24l01_fec_gf_log[256];
+static uint8_t nrf24l01_fec_gf_ready = 0;
+
+typedef struct nrf24l01_fec {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					data_cnt;			/*!< Data frames per group, K */
+	uint8_t 					parity_cnt;			/*!< Parity frames per group, M */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					data_len;			/*!< Data length of one frame */
+	uint8_t 					*frame;				/*!< Frame buffer, packet_len bytes */
+	uint8_t 					tx_group;			/*!< Transmitted group number */
+	uint8_t 					tx_idx;				/*!< Next data frame index in transmitted group */
+	uint8_t 					*tx_parity;			/*!< Parity accumulators, M frames */
+	uint8_t 					rx_valid;			/*!< A group is being received */
+	uint8_t 					rx_group;			/*!< Received group number */
+	uint8_t 					rx_k;				/*!< Data frames in received group */
+	uint8_t 					rx_done;			/*!< All data frames of received group are output */
+	uint64_t 					rx_recv;			/*!< Received frames of the group */
+	uint8_t 					*rx_buf;			/*!< Received frames, K + M frames */
+	nrf24l01_fec_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_fec_t;
+
+static void nrf24l01_fec_gf_init(void)
+{
+	uint16_t x = 1;
+
+	for (uint16_t i = 0; i < 255; i++)
+	{
+		nrf24l01_fec_gf_exp[i] = x;
+		nrf24l01_fec_gf_log[x] = i;
+
+		x <<= 1;
+		if (x & 0x100)
+		{
+			x ^= NRF24L01_FEC_GF_POLY;
+		}
+	}
+
+	for (uint16_t i = 255; i < 512; i++)
+	{
+		nrf24l01_fec_gf_exp[i] = nrf24l01_fec_gf_exp[i - 255];
+	}
+
+	nrf24l01_fec_gf_ready = 1;
+}
+
+static uint8_t nrf24l01_fec_gf_mul(uint8_t a, uint8_t b)
+{
+	if ((a == 0) || (b == 0))
+	{
+		return 0;
+	}
+
+	return nrf24l01_fec_gf_exp[nrf24l01_fec_gf_log[a] + nrf24l01_fec_gf_log[b]];
+}
+
+static uint8_t nrf24l01_fec_gf_inv(uint8_t a)
+{
+	return nrf24l01_fec_gf_exp[255 - nrf24l01_fec_gf_log[a]];
+}
+
+/**
+ * @brief   dst += coef * src over a whole frame. Coefficient 1 reduces to a
+ * 			plain XOR loop.
+ */
+static void nrf24l01_fec_mul_add(uint8_t *dst, const uint8_t *src, uint8_t coef, uint8_t len)
+{
+	if (coef == 0)
+	{
+		return;
+	}
+
+	if (coef == 1)
+	{
+		for (uint8_t i = 0; i < len; i++)
+		{
+			dst[i] ^= src[i];
+		}
+		return;
+	}
+
+	uint16_t log_coef = nrf24l01_fec_gf_log[coef];
+	for (uint8_t i = 0; i < len; i++)
+	{
+		if (src[i] != 0)
+		{
+			dst[i] ^= nrf24l01_fec_gf_exp[log_coef + nrf24l01_fec_gf_log[src[i]]];
+		}
+	}
+}
+
+static void nrf24l01_fec_mul(uint8_t *dst, uint8_t coef, uint8_t len)
+{
+	for (uint8_t i = 0; i < len; i++)
+	{
+		dst[i] = nrf24l01_fec_gf_mul(dst[i], coef);
+	}
+}
+
+/**
+ * @brief   Coefficient of data frame "data_idx" in parity frame "parity_idx".
+ * 			Cauchy matrix 1 / (x + y) with x = K + parity_idx, y = data_idx, so
+ * 			every square sub-matrix is invertible.
+ */
+static uint8_t nrf24l01_fec_coef(nrf24l01_fec_handle_t handle, uint8_t parity_idx, uint8_t data_idx)
+{
+	if (handle->parity_cnt == 1)
+	{
+		return 1;
+	}
+
+	return nrf24l01_fec_gf_inv((handle->data_cnt + parity_idx) ^ data_idx);
+}
+
+static uint8_t *nrf24l01_fec_rx_frame(nrf24l01_fec_handle_t handle, uint8_t idx)
+{
+	return &handle->rx_buf[(uint16_t)idx * handle->data_len];
+}
+
+static err_code_t nrf24l01_fec_send_parity(nrf24l01_fec_handle_t handle, uint32_t timeout_ms)
+{
+	err_code_t err_ret;
+
+	for (uint8_t j = 0; j < handle->parity_cnt; j++)
+	{
+		handle->frame[0] = handle->tx_group;
+		handle->frame[1] = handle->data_cnt + j;
+		handle->frame[2] = handle->tx_idx;
+		memcpy(&handle->frame[NRF24L01_FEC_HEADER_LEN], &handle->tx_parity[(uint16_t)j * handle->data_len], handle->data_len);
+
+		err_ret = nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, timeout_ms);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+	}
+
+	handle->tx_idx = 0;
+	handle->tx_group++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+static void nrf24l01_fec_decode(nrf24l01_fec_handle_t handle, uint8_t *data, uint8_t *data_idx, uint8_t *data_cnt)
+{
+	uint8_t erasure[NRF24L01_FEC_MAX_PARITY_CNT];
+	uint8_t parity[NRF24L01_FEC_MAX_PARITY_CNT];
+	uint8_t erasure_cnt = 0;
+	uint8_t parity_cnt = 0;
+
+	for (uint8_t i = 0; i < handle->rx_k; i++)
+	{
+		if (!(handle->rx_recv & ((uint64_t)1 << i)))
+		{
+			if (erasure_cnt == handle->parity_cnt)
+			{
+				return;
+			}
+			erasure[erasure_cnt++] = i;
+		}
+	}
+
+	if (erasure_cnt == 0)
+	{
+		handle->rx_done = 1;
+		return;
+	}
+
+	for (uint8_t j = 0; (j < handle->parity_cnt) && (parity_cnt < erasure_cnt); j++)
+	{
+		if (handle->rx_recv & ((uint64_t)1 << (handle->data_cnt + j)))
+		{
+			parity[parity_cnt++] = j;
+		}
+	}
+
+	if (parity_cnt < erasure_cnt)
+	{
+		return;
+	}
+
+	/* Remove known data frames from parity frames, leaving A * erased = rhs */
+	uint8_t matrix[NRF24L01_FEC_MAX_PARITY_CNT][NRF24L01_FEC_MAX_PARITY_CNT];
+	uint8_t *rhs[NRF24L01_FEC_MAX_PARITY_CNT];
+
+	for (uint8_t r = 0; r < erasure_cnt; r++)
+	{
+		rhs[r] = nrf24l01_fec_rx_frame(handle, handle->data_cnt + parity[r]);
+
+		for (uint8_t i = 0; i < handle->rx_k; i++)
+		{
+			if (handle->rx_recv & ((uint64_t)1 << i))
+			{
+				nrf24l01_fec_mul_add(rhs[r], nrf24l01_fec_rx_frame(handle, i), nrf24l01_fec_coef(handle, parity[r], i), handle->data_len);
+			}
+		}
+
+		for (uint8_t c = 0; c < erasure_cnt; c++)
+		{
+			matrix[r][c] = nrf24l01_fec_coef(handle, parity[r], erasure[c]);
+		}
+	}
+
+	/* Gauss-Jordan elimination, row operations are applied to whole frames */
+	for (uint8_t c = 0; c < erasure_cnt; c++)
+	{
+		uint8_t pivot = c;
+		while (matrix[pivot][c] == 0)
+		{
+			pivot++;
+		}
+
+		if (pivot != c)
+		{
+			for (uint8_t k = 0; k < erasure_cnt; k++)
+			{
+				uint8_t tmp = matrix[c][k];
+				matrix[c][k] = matrix[pivot][k];
+				matrix[pivot][k] = tmp;
+			}
+
+			uint8_t *tmp_rhs = rhs[c];
+			rhs[c] = rhs[pivot];
+			rhs[pivot] = tmp_rhs;
+		}
+
+		uint8_t inv = nrf24l01_fec_gf_inv(matrix[c][c]);
+		for (uint8_t k = 0; k < erasure_cnt; k++)
+		{
+			matrix[c][k] = nrf24l01_fec_gf_mul(matrix[c][k], inv);
+		}
+		nrf24l01_fec_mul(rhs[c], inv, handle->data_len);
+
+		for (uint8_t r = 0; r < erasure_cnt; r++)
+		{
+			uint8_t factor = matrix[r][c];
+			if ((r == c) || (factor == 0))
+			{
+				continue;
+			}
+
+			for (uint8_t k = 0; k < erasure_cnt; k++)
+			{
+				matrix[r][k] ^= nrf24l01_fec_gf_mul(factor, matrix[c][k]);
+			}
+			nrf24l01_fec_mul_add(rhs[r], rhs[c], factor, handle->data_len);
+		}
+	}
+
+	for (uint8_t c = 0; c < erasure_cnt; c++)
+	{
+		memcpy(nrf24l01_fec_rx_frame(handle, erasure[c]), rhs[c], handle->data_len);
+		memcpy(&data[(uint16_t)(*data_cnt) * handle->data_len], rhs[c], handle->data_len);
+		data_idx[*data_cnt] = erasure[c];
+		(*data_cnt)++;
+		handle->rx_recv |= (uint64_t)1 << erasure[c];
+	}
+
+	handle->stats.num_recovered += erasure_cnt;
+	handle->rx_done = 1;
+}
+
+nrf24l01_fec_handle_t nrf24l01_fec_init(void)
+{
+	nrf24l01_fec_handle_t handle = calloc(1, sizeof(nrf24l01_fec_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_fec_set_config(nrf24l01_fec_handle_t handle, nrf24l01_fec_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->data_cnt = config.data_cnt;
+	handle->parity_cnt = config.parity_cnt;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_fec_config(nrf24l01_fec_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->data_cnt == 0) || (handle->data_cnt > NRF24L01_FEC_MAX_DATA_CNT) ||
+	    (handle->parity_cnt == 0) || (handle->parity_cnt > NRF24L01_FEC_MAX_PARITY_CNT))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if (radio_cfg.packet_len <= NRF24L01_FEC_HEADER_LEN)
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+	handle->data_len = radio_cfg.packet_len - NRF24L01_FEC_HEADER_LEN;
+
+	if (!nrf24l01_fec_gf_ready)
+	{
+		nrf24l01_fec_gf_init();
+	}
+
+	free(handle->frame);
+	free(handle->tx_parity);
+	free(handle->rx_buf);
+
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	handle->tx_parity = calloc(handle->parity_cnt, handle->data_len);
+	handle->rx_buf = calloc(handle->data_cnt + handle->parity_cnt, handle->data_len);
+	if ((handle->frame == NULL) || (handle->tx_parity == NULL) || (handle->rx_buf == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->tx_group = 0;
+	handle->tx_idx = 0;
+	handle->rx_valid = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_fec_get_data_len(nrf24l01_fec_handle_t handle, uint8_t *data_len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (data_len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*data_len = handle->data_len;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_fec_transmit(nrf24l01_fec_handle_t handle, uint8_t *data, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->tx_idx == 0)
+	{
+		memset(handle->tx_parity, 0, (uint16_t)handle->parity_cnt * handle->data_len);
+	}
+
+	handle->frame[0] = handle->tx_group;
+	handle->frame[1] = handle->tx_idx;
+	handle->frame[2] = handle->data_cnt;
+	memcpy(&handle->frame[NRF24L01_FEC_HEADER_LEN], data, handle->data_len);
+
+	err_code_t err_ret = nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, timeout_ms);
+	if (err_ret != ERR_CODE_SUCCESS)
+	{
+		return err_ret;
+	}
+
+	for (uint8_t j = 0; j < handle->parity_cnt; j++)
+	{
+		nrf24l01_fec_mul_add(&handle->tx_parity[(uint16_t)j * handle->data_len], data,
+		                     nrf24l01_fec_coef(handle, j, handle->tx_idx), handle->data_len);
+	}
+	handle->tx_idx++;
+
+	if (handle->tx_idx == handle->data_cnt)
+	{
+		return nrf24l01_fec_send_parity(handle, timeout_ms);
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_fec_flush(nrf24l01_fec_handle_t handle, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->tx_idx != 0)
+	{
+		err_code_t err_ret = nrf24l01_fec_send_parity(handle, timeout_ms);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			return err_ret;
+		}
+	}
+
+	return nrf24l01_wait_tx_complete(handle->radio, timeout_ms);
+}
+
+err_code_t nrf24l01_fec_receive(nrf24l01_fec_handle_t handle, uint8_t *rx_payload, uint8_t *data, uint8_t *data_idx, uint8_t *data_group, uint8_t *data_cnt)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (rx_payload == NULL) || (data == NULL) || (data_idx == NULL) ||
+	    (data_group == NULL) || (data_cnt == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*data_cnt = 0;
+	*data_group = rx_payload[0];
+
+	uint8_t group = rx_payload[0];
+	uint8_t idx = rx_payload[1];
+	uint8_t k = rx_payload[2];
+
+	if ((idx >= (handle->data_cnt + handle->parity_cnt)) || (k == 0) || (k > handle->data_cnt))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	if (handle->rx_valid && (group != handle->rx_group))
+	{
+		/* Frame of an older group arrives late */
+		if ((int8_t)(group - handle->rx_group) < 0)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+
+		if (!handle->rx_done)
+		{
+			for (uint8_t i = 0; i < handle->rx_k; i++)
+			{
+				if (!(handle->rx_recv & ((uint64_t)1 << i)))
+				{
+					handle->stats.num_lost++;
+				}
+			}
+		}
+
+		handle->rx_valid = 0;
+	}
+
+	if (!handle->rx_valid)
+	{
+		handle->rx_valid = 1;
+		handle->rx_group = group;
+		handle->rx_k = handle->data_cnt;
+		handle->rx_done = 0;
+		handle->rx_recv = 0;
+		handle->stats.num_group++;
+	}
+
+	if (handle->rx_done || (handle->rx_recv & ((uint64_t)1 << idx)))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	/* Only parity frames know how many data frames a flushed group has */
+	if (idx >= handle->data_cnt)
+	{
+		handle->rx_k = k;
+	}
+	else if (idx >= handle->rx_k)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	memcpy(nrf24l01_fec_rx_frame(handle, idx), &rx_payload[NRF24L01_FEC_HEADER_LEN], handle->data_len);
+	handle->rx_recv |= (uint64_t)1 << idx;
+
+	if (idx < handle->data_cnt)
+	{
+		memcpy(&data[(uint16_t)(*data_cnt) * handle->data_len], &rx_payload[NRF24L01_FEC_HEADER_LEN], handle->data_len);
+		data_idx[*data_cnt] = idx;
+		(*data_cnt)++;
+	}
+
+	nrf24l01_fec_decode(handle, data, data_idx, data_cnt);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_fec_get_stats(nrf24l01_fec_handle_t handle, nrf24l01_fec_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
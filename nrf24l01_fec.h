@@ -0,0 +1,182 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_FEC_H__
+#define __NRF24L01_FEC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Frames are coded in groups of K data frames followed by M parity
+ * 			frames. Each frame carries group number, frame index and number of
+ * 			data frames in the group, packet_len - 3 bytes of data remain. Any K
+ * 			frames of a group are enough to rebuild the lost data frames.
+ * 			M = 1 uses XOR parity, M > 1 uses Cauchy Reed-Solomon over GF(256).
+ */
+#define NRF24L01_FEC_HEADER_LEN 		3
+#define NRF24L01_FEC_MAX_DATA_CNT 		32
+#define NRF24L01_FEC_MAX_PARITY_CNT 	8
+
+/**
+ * @brief   FEC handle structure.
+ */
+typedef struct nrf24l01_fec* nrf24l01_fec_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					data_cnt;			/*!< Data frames per group, K */
+	uint8_t 					parity_cnt;			/*!< Parity frames per group, M */
+} nrf24l01_fec_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_group;			/*!< Groups received */
+	uint32_t 					num_recovered;		/*!< Data frames rebuilt from parity */
+	uint32_t 					num_lost;			/*!< Data frames which could not be rebuilt */
+} nrf24l01_fec_stats_t;
+
+/*
+ * @brief   Initialize FEC codec.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_fec_handle_t nrf24l01_fec_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_set_config(nrf24l01_fec_handle_t handle, nrf24l01_fec_cfg_t config);
+
+/*
+ * @brief   Configure FEC codec to run. Group buffers are allocated here.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_config(nrf24l01_fec_handle_t handle);
+
+/*
+ * @brief   Get data length of one frame, packet_len - 3.
+ *
+ * @param 	handle Handle structure.
+ * @param 	data_len Data length.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_get_data_len(nrf24l01_fec_handle_t handle, uint8_t *data_len);
+
+/*
+ * @brief   Transmit one data frame without ACK request. Parity is updated on
+ * 			the fly and parity frames are transmitted after the K-th data frame.
+ *
+ * @note 	Function "delay" of the radio need to be assigned.
+ *
+ * @param 	handle Handle structure.
+ * @param 	data Data, data length bytes.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_transmit(nrf24l01_fec_handle_t handle, uint8_t *data, uint32_t timeout_ms);
+
+/*
+ * @brief   Close current group before K data frames are sent. Parity frames
+ * 			are transmitted at once, missing data frames count as zero.
+ *
+ * @param 	handle Handle structure.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_flush(nrf24l01_fec_handle_t handle, uint32_t timeout_ms);
+
+/*
+ * @brief   Feed one received frame. Data frames are output at once, data
+ * 			frames rebuilt from parity are output when enough frames of the
+ * 			group are received, so output order may differ from sending order.
+ * 			Each output frame comes with its index in the group, frames of one
+ * 			call all belong to group "data_group".
+ *
+ * @param 	handle Handle structure.
+ * @param 	rx_payload Received frame, packet_len bytes.
+ * @param 	data Output buffer, K * data length bytes.
+ * @param 	data_idx Index in the group of each output frame, K bytes.
+ * @param 	data_group Group number of output frames.
+ * @param 	data_cnt Number of data frames written to output buffer.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_receive(nrf24l01_fec_handle_t handle, uint8_t *rx_payload, uint8_t *data, uint8_t *data_idx, uint8_t *data_group, uint8_t *data_cnt);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_fec_get_stats(nrf24l01_fec_handle_t handle, nrf24l01_fec_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_FEC_H__ */
@@ -0,0 +1,322 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_frag.h"
+
+#define NRF24L01_FRAG_BITMAP_LEN 		((NRF24L01_FRAG_MAX_FRAG_CNT + 8) / 8)
+
+/**
+ * @brief   Reassembly slot.
+ */
+typedef struct {
+	uint8_t 					in_use;				/*!< Slot holds an incomplete message */
+	uint8_t 					msg_id;				/*!< Message id */
+	uint8_t 					frag_cnt;			/*!< Number of fragments of the message */
+	uint8_t 					recv_cnt;			/*!< Number of fragments received */
+	uint16_t 					msg_len;			/*!< Message length, known when last fragment is received */
+	uint32_t 					last_tick;			/*!< Tick of last received fragment */
+	uint8_t 					bitmap[NRF24L01_FRAG_BITMAP_LEN];	/*!< Received fragments */
+	uint8_t 					*buf;				/*!< Message buffer, max_msg_len bytes from pool */
+} nrf24l01_frag_slot_t;
+
+typedef struct nrf24l01_frag {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					num_slot;			/*!< Number of messages reassembled at the same time */
+	uint16_t 					max_msg_len;		/*!< Maximum message length */
+	uint32_t 					timeout_ms;			/*!< Incomplete message is dropped after this time */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+	nrf24l01_func_delay 		delay;				/*!< Function delay of the radio */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					msg_id;				/*!< Next transmitted message id */
+	uint8_t 					*frame;				/*!< TX frame buffer, packet_len bytes */
+	uint8_t 					*rx_frame;			/*!< RX frame buffer, packet_len bytes */
+	uint8_t 					*pool;				/*!< Reassembly buffer pool */
+	nrf24l01_frag_slot_t 		*slot;				/*!< Reassembly slots */
+} nrf24l01_frag_t;
+
+static void nrf24l01_frag_expire(nrf24l01_frag_handle_t handle, uint32_t now)
+{
+	for (uint8_t i = 0; i < handle->num_slot; i++)
+	{
+		if (handle->slot[i].in_use && ((now - handle->slot[i].last_tick) > handle->timeout_ms))
+		{
+			handle->slot[i].in_use = 0;
+		}
+	}
+}
+
+static nrf24l01_frag_slot_t *nrf24l01_frag_get_slot(nrf24l01_frag_handle_t handle, uint8_t msg_id, uint8_t frag_cnt, uint32_t now)
+{
+	nrf24l01_frag_slot_t *free_slot = NULL;
+	nrf24l01_frag_slot_t *oldest_slot = &handle->slot[0];
+
+	for (uint8_t i = 0; i < handle->num_slot; i++)
+	{
+		nrf24l01_frag_slot_t *slot = &handle->slot[i];
+
+		if (!slot->in_use)
+		{
+			if (free_slot == NULL)
+			{
+				free_slot = slot;
+			}
+			continue;
+		}
+
+		if ((slot->msg_id == msg_id) && (slot->frag_cnt == frag_cnt))
+		{
+			return slot;
+		}
+
+		if ((now - slot->last_tick) > (now - oldest_slot->last_tick))
+		{
+			oldest_slot = slot;
+		}
+	}
+
+	/* All slots are busy, drop the oldest incomplete message */
+	nrf24l01_frag_slot_t *slot = (free_slot != NULL) ? free_slot : oldest_slot;
+
+	slot->in_use = 1;
+	slot->msg_id = msg_id;
+	slot->frag_cnt = frag_cnt;
+	slot->recv_cnt = 0;
+	slot->msg_len = 0;
+	memset(slot->bitmap, 0, NRF24L01_FRAG_BITMAP_LEN);
+
+	return slot;
+}
+
+nrf24l01_frag_handle_t nrf24l01_frag_init(void)
+{
+	nrf24l01_frag_handle_t handle = calloc(1, sizeof(nrf24l01_frag_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_frag_set_config(nrf24l01_frag_handle_t handle, nrf24l01_frag_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->num_slot = config.num_slot;
+	handle->max_msg_len = config.max_msg_len;
+	handle->timeout_ms = config.timeout_ms;
+	handle->get_tick = config.get_tick;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_frag_config(nrf24l01_frag_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->num_slot == 0) || (handle->get_tick == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if ((radio_cfg.packet_len <= NRF24L01_FRAG_HEADER_LEN) || (radio_cfg.delay == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+	handle->delay = radio_cfg.delay;
+
+	free(handle->frame);
+	free(handle->rx_frame);
+	free(handle->pool);
+	free(handle->slot);
+
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	handle->rx_frame = calloc(handle->packet_len, sizeof(uint8_t));
+	handle->pool = calloc(handle->num_slot, handle->max_msg_len);
+	handle->slot = calloc(handle->num_slot, sizeof(nrf24l01_frag_slot_t));
+	if ((handle->frame == NULL) || (handle->rx_frame == NULL) || (handle->pool == NULL) || (handle->slot == NULL))
+	{
+		free(handle->frame);
+		free(handle->rx_frame);
+		free(handle->pool);
+		free(handle->slot);
+		handle->frame = NULL;
+		handle->rx_frame = NULL;
+		handle->pool = NULL;
+		handle->slot = NULL;
+		return ERR_CODE_FAIL;
+	}
+
+	for (uint8_t i = 0; i < handle->num_slot; i++)
+	{
+		handle->slot[i].buf = &handle->pool[(uint32_t)i * handle->max_msg_len];
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_frag_transmit(nrf24l01_frag_handle_t handle, uint8_t *msg, uint16_t msg_len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || ((msg == NULL) && (msg_len != 0)))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Not configured */
+	if (handle->frame == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t chunk_len = handle->packet_len - NRF24L01_FRAG_HEADER_LEN;
+	uint16_t frag_cnt = (msg_len + chunk_len - 1) / chunk_len;
+	if (frag_cnt == 0)
+	{
+		frag_cnt = 1;
+	}
+
+	if (frag_cnt > NRF24L01_FRAG_MAX_FRAG_CNT)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret;
+	uint16_t offset = 0;
+
+	for (uint16_t frag_idx = 0; frag_idx < frag_cnt; frag_idx++)
+	{
+		uint8_t len = ((msg_len - offset) > chunk_len) ? chunk_len : (msg_len - offset);
+
+		handle->frame[0] = handle->msg_id;
+		handle->frame[1] = frag_idx;
+		handle->frame[2] = frag_cnt;
+		handle->frame[3] = len;
+		memcpy(&handle->frame[NRF24L01_FRAG_HEADER_LEN], &msg[offset], len);
+		memset(&handle->frame[NRF24L01_FRAG_HEADER_LEN + len], 0, chunk_len - len);
+
+		err_ret = nrf24l01_transmit_pipelined(handle->radio, handle->frame, timeout_ms);
+		if (err_ret != ERR_CODE_SUCCESS)
+		{
+			handle->msg_id++;
+			return err_ret;
+		}
+
+		offset += len;
+	}
+
+	handle->msg_id++;
+
+	return nrf24l01_wait_tx_complete(handle->radio, timeout_ms);
+}
+
+err_code_t nrf24l01_frag_receive(nrf24l01_frag_handle_t handle, uint8_t *rx_payload, uint8_t **msg, uint16_t *msg_len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (rx_payload == NULL) || (msg == NULL) || (msg_len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*msg = NULL;
+	*msg_len = 0;
+
+	/* Not configured */
+	if (handle->slot == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint32_t now = handle->get_tick();
+	nrf24l01_frag_expire(handle, now);
+
+	uint8_t msg_id = rx_payload[0];
+	uint8_t frag_idx = rx_payload[1];
+	uint8_t frag_cnt = rx_payload[2];
+	uint8_t len = rx_payload[3];
+	uint8_t chunk_len = handle->packet_len - NRF24L01_FRAG_HEADER_LEN;
+	uint32_t offset = (uint32_t)frag_idx * chunk_len;
+
+	/* Drop malformed frames and messages which do not fit a slot */
+	if ((frag_idx >= frag_cnt) || (len > chunk_len) ||
+	    ((frag_idx != (frag_cnt - 1)) && (len != chunk_len)) ||
+	    ((offset + len) > handle->max_msg_len))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_frag_slot_t *slot = nrf24l01_frag_get_slot(handle, msg_id, frag_cnt, now);
+	slot->last_tick = now;
+
+	/* Duplicated fragment */
+	if (slot->bitmap[frag_idx / 8] & (1 << (frag_idx % 8)))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	memcpy(&slot->buf[offset], &rx_payload[NRF24L01_FRAG_HEADER_LEN], len);
+	slot->bitmap[frag_idx / 8] |= 1 << (frag_idx % 8);
+	slot->recv_cnt++;
+
+	if (frag_idx == (frag_cnt - 1))
+	{
+		slot->msg_len = offset + len;
+	}
+
+	if (slot->recv_cnt == slot->frag_cnt)
+	{
+		slot->in_use = 0;
+		*msg = slot->buf;
+		*msg_len = slot->msg_len;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_frag_receive_polling(nrf24l01_frag_handle_t handle, uint8_t **msg, uint16_t *msg_len, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (msg == NULL) || (msg_len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*msg = NULL;
+
+	/* Not configured */
+	if (handle->rx_frame == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint32_t start = handle->get_tick();
+
+	while ((handle->get_tick() - start) < timeout_ms)
+	{
+		if (nrf24l01_try_receive(handle->radio, handle->rx_frame) != ERR_CODE_SUCCESS)
+		{
+			handle->delay(1);
+			continue;
+		}
+
+		nrf24l01_frag_receive(handle, handle->rx_frame, msg, msg_len);
+		if (*msg != NULL)
+		{
+			return ERR_CODE_SUCCESS;
+		}
+	}
+
+	return ERR_CODE_FAIL;
+}
@@ -0,0 +1,155 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_FRAG_H__
+#define __NRF24L01_FRAG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Fragment header length. Each frame carries message id, fragment
+ * 			index, fragment count and data length, packet_len - 4 bytes of data
+ * 			remain. A message is split into at most 255 fragments.
+ */
+#define NRF24L01_FRAG_HEADER_LEN 		4
+#define NRF24L01_FRAG_MAX_FRAG_CNT 		255
+
+/**
+ * @brief   Fragmentation handle structure.
+ */
+typedef struct nrf24l01_frag* nrf24l01_frag_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					num_slot;			/*!< Number of messages reassembled at the same time */
+	uint16_t 					max_msg_len;		/*!< Maximum message length */
+	uint32_t 					timeout_ms;			/*!< Incomplete message is dropped after this time */
+	nrf24l01_func_get_tick 		get_tick;			/*!< Function get tick in ms */
+} nrf24l01_frag_cfg_t;
+
+/*
+ * @brief   Initialize fragmentation layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_frag_handle_t nrf24l01_frag_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_frag_set_config(nrf24l01_frag_handle_t handle, nrf24l01_frag_cfg_t config);
+
+/*
+ * @brief   Configure fragmentation layer to run. Reassembly buffers for all
+ * 			slots are allocated once here.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before, with
+ * 			function "delay" assigned.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_frag_config(nrf24l01_frag_handle_t handle);
+
+/*
+ * @brief   Split message into frames and transmit them. Frames are queued in TX
+ * 			FIFO back to back by "nrf24l01_transmit_pipelined".
+ *
+ * @note 	Function "delay" of the radio need to be assigned.
+ *
+ * @param 	handle Handle structure.
+ * @param 	msg Message.
+ * @param 	msg_len Message length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_frag_transmit(nrf24l01_frag_handle_t handle, uint8_t *msg, uint16_t msg_len, uint32_t timeout_ms);
+
+/*
+ * @brief   Feed one received frame into reassembly. When the frame completes a
+ * 			message, "msg" points to the reassembled message, else it is NULL.
+ * 			Incomplete messages older than "timeout_ms" are dropped.
+ *
+ * @note 	Message buffer is valid until next call of this function.
+ *
+ * @param 	handle Handle structure.
+ * @param 	rx_payload Received frame, packet_len bytes.
+ * @param 	msg Reassembled message.
+ * @param 	msg_len Reassembled message length.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_frag_receive(nrf24l01_frag_handle_t handle, uint8_t *rx_payload, uint8_t **msg, uint16_t *msg_len);
+
+/*
+ * @brief   Receive frames from the radio until a message is complete or timeout.
+ *
+ * @note    RX FIFO is polled through FIFO_STATUS every 1 ms, the IRQ pin is
+ * 			not used.
+ * 			Message buffer is valid until next call of "nrf24l01_frag_receive"
+ * 			or this function.
+ *
+ * @param 	handle Handle structure.
+ * @param 	msg Reassembled message.
+ * @param 	msg_len Reassembled message length.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_frag_receive_polling(nrf24l01_frag_handle_t handle, uint8_t **msg, uint16_t *msg_len, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_FRAG_H__ */
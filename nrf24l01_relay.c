@@ -0,0 +1,354 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_relay.h"
+
+#define NRF24L01_RELAY_OFS_DST 			0
+#define NRF24L01_RELAY_OFS_SRC 			1
+#define NRF24L01_RELAY_OFS_HOPS 		2
+#define NRF24L01_RELAY_OFS_LEN 			3
+#define NRF24L01_RELAY_OFS_LATENCY 		4
+
+/**
+ * @brief   Routing table entry.
+ */
+typedef struct {
+	uint8_t 					dst;				/*!< Destination node id */
+	uint8_t 					next_hop;			/*!< Neighbor node id */
+} nrf24l01_relay_route_t;
+
+typedef struct nrf24l01_relay {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					node_id;			/*!< Own node id */
+	uint8_t 					addr[5];			/*!< Address buffer, base address */
+	uint8_t 					num_route;			/*!< Size of routing table */
+	uint8_t 					max_hops;			/*!< Maximum number of hops */
+	uint32_t 					tx_timeout_ms;		/*!< Timeout of one frame transmission */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					route_cnt;			/*!< Routes in use */
+	uint8_t 					default_route;		/*!< Next hop when no route matches */
+	nrf24l01_relay_route_t 		*route;				/*!< Routing table */
+	uint8_t 					*frame;				/*!< Frame buffer, packet_len bytes */
+	nrf24l01_relay_stats_t 		stats;				/*!< Statistics */
+} nrf24l01_relay_t;
+
+static uint8_t nrf24l01_relay_lookup(nrf24l01_relay_handle_t handle, uint8_t dst)
+{
+	for (uint8_t i = 0; i < handle->route_cnt; i++)
+	{
+		if (handle->route[i].dst == dst)
+		{
+			return handle->route[i].next_hop;
+		}
+	}
+
+	return handle->default_route;
+}
+
+static err_code_t nrf24l01_relay_send_frame(nrf24l01_relay_handle_t handle, uint8_t next_hop)
+{
+	err_code_t err_ret;
+
+	/* Pipe 0 follows TX address to receive ACK */
+	handle->addr[0] = next_hop;
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+	nrf24l01_set_tx_address(handle->radio, handle->addr);
+	nrf24l01_set_rx_address(handle->radio, 0, handle->addr);
+
+	err_ret = nrf24l01_transmit_pipelined(handle->radio, handle->frame, handle->tx_timeout_ms);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, handle->tx_timeout_ms);
+	}
+
+	if (err_ret != ERR_CODE_SUCCESS)
+	{
+		nrf24l01_flush_tx_fifo(handle->radio);
+		handle->stats.num_tx_fail++;
+	}
+
+	/* Stop listening on the neighbor address, otherwise this node would
+	 * acknowledge frames meant for it */
+	nrf24l01_disable_rx_pipe(handle->radio, 0);
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	return err_ret;
+}
+
+static void nrf24l01_relay_forward(nrf24l01_relay_handle_t handle, uint32_t rx_time)
+{
+	uint8_t *frame = handle->frame;
+	uint8_t hops = frame[NRF24L01_RELAY_OFS_HOPS] + 1;
+
+	if ((hops == 0) || (hops > handle->max_hops))
+	{
+		handle->stats.num_hop_limit++;
+		return;
+	}
+
+	uint8_t next_hop = nrf24l01_relay_lookup(handle, frame[NRF24L01_RELAY_OFS_DST]);
+	if ((next_hop == NRF24L01_RELAY_NO_ROUTE) || (next_hop == handle->node_id))
+	{
+		handle->stats.num_no_route++;
+		return;
+	}
+
+	/* Add time spent in this node up to TX FIFO write, saturated */
+	uint32_t latency = frame[NRF24L01_RELAY_OFS_LATENCY] | ((uint32_t)frame[NRF24L01_RELAY_OFS_LATENCY + 1] << 8);
+	latency += (handle->get_time_us() - rx_time) / NRF24L01_RELAY_LATENCY_UNIT_US;
+	if (latency > 0xFFFF)
+	{
+		latency = 0xFFFF;
+	}
+
+	frame[NRF24L01_RELAY_OFS_HOPS] = hops;
+	frame[NRF24L01_RELAY_OFS_LATENCY] = latency & 0xFF;
+	frame[NRF24L01_RELAY_OFS_LATENCY + 1] = latency >> 8;
+
+	nrf24l01_relay_send_frame(handle, next_hop);
+
+	uint32_t forward_us = handle->get_time_us() - rx_time;
+
+	handle->stats.num_forward++;
+	handle->stats.sum_forward_us += forward_us;
+	if (forward_us > handle->stats.max_forward_us)
+	{
+		handle->stats.max_forward_us = forward_us;
+	}
+}
+
+nrf24l01_relay_handle_t nrf24l01_relay_init(void)
+{
+	nrf24l01_relay_handle_t handle = calloc(1, sizeof(nrf24l01_relay_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_relay_set_config(nrf24l01_relay_handle_t handle, nrf24l01_relay_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->node_id = config.node_id;
+	memcpy(handle->addr, config.base_addr, sizeof(handle->addr));
+	handle->num_route = config.num_route;
+	handle->max_hops = config.max_hops;
+	handle->tx_timeout_ms = config.tx_timeout_ms;
+	handle->get_time_us = config.get_time_us;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_relay_config(nrf24l01_relay_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->get_time_us == NULL) || (handle->node_id == NRF24L01_RELAY_NO_ROUTE))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if (radio_cfg.packet_len <= NRF24L01_RELAY_HEADER_LEN)
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+
+	free(handle->route);
+	free(handle->frame);
+
+	handle->route = calloc(handle->num_route, sizeof(nrf24l01_relay_route_t));
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	if (((handle->route == NULL) && (handle->num_route != 0)) || (handle->frame == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->route_cnt = 0;
+	handle->default_route = NRF24L01_RELAY_NO_ROUTE;
+	memset(&handle->stats, 0, sizeof(nrf24l01_relay_stats_t));
+
+	/* Pipe 0 is only enabled while waiting for ACK of a sent frame */
+	handle->addr[0] = handle->node_id;
+	nrf24l01_disable_rx_pipe(handle->radio, 0);
+	nrf24l01_set_rx_address(handle->radio, 1, handle->addr);
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_relay_set_route(nrf24l01_relay_handle_t handle, uint8_t dst, uint8_t next_hop)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint8_t i = 0; i < handle->route_cnt; i++)
+	{
+		if (handle->route[i].dst == dst)
+		{
+			handle->route[i].next_hop = next_hop;
+			return ERR_CODE_SUCCESS;
+		}
+	}
+
+	if (handle->route_cnt >= handle->num_route)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->route[handle->route_cnt].dst = dst;
+	handle->route[handle->route_cnt].next_hop = next_hop;
+	handle->route_cnt++;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_relay_del_route(nrf24l01_relay_handle_t handle, uint8_t dst)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint8_t i = 0; i < handle->route_cnt; i++)
+	{
+		if (handle->route[i].dst == dst)
+		{
+			handle->route_cnt--;
+			handle->route[i] = handle->route[handle->route_cnt];
+			return ERR_CODE_SUCCESS;
+		}
+	}
+
+	return ERR_CODE_FAIL;
+}
+
+err_code_t nrf24l01_relay_set_default_route(nrf24l01_relay_handle_t handle, uint8_t next_hop)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->default_route = next_hop;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_relay_transmit(nrf24l01_relay_handle_t handle, uint8_t dst, uint8_t *data, uint8_t len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (data == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Zero length is reserved for "no data" in nrf24l01_relay_process */
+	if ((len == 0) || (len > (handle->packet_len - NRF24L01_RELAY_HEADER_LEN)))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t next_hop = nrf24l01_relay_lookup(handle, dst);
+	if (next_hop == NRF24L01_RELAY_NO_ROUTE)
+	{
+		handle->stats.num_no_route++;
+		return ERR_CODE_FAIL;
+	}
+
+	handle->frame[NRF24L01_RELAY_OFS_DST] = dst;
+	handle->frame[NRF24L01_RELAY_OFS_SRC] = handle->node_id;
+	handle->frame[NRF24L01_RELAY_OFS_HOPS] = 0;
+	handle->frame[NRF24L01_RELAY_OFS_LEN] = len;
+	handle->frame[NRF24L01_RELAY_OFS_LATENCY] = 0;
+	handle->frame[NRF24L01_RELAY_OFS_LATENCY + 1] = 0;
+	/* Data may be the pointer returned by nrf24l01_relay_process */
+	memmove(&handle->frame[NRF24L01_RELAY_HEADER_LEN], data, len);
+	memset(&handle->frame[NRF24L01_RELAY_HEADER_LEN + len], 0, handle->packet_len - NRF24L01_RELAY_HEADER_LEN - len);
+
+	handle->stats.num_tx++;
+
+	return nrf24l01_relay_send_frame(handle, next_hop);
+}
+
+err_code_t nrf24l01_relay_process(nrf24l01_relay_handle_t handle, uint8_t *src, uint8_t **data, uint8_t *len)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (src == NULL) || (data == NULL) || (len == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	uint8_t *frame = handle->frame;
+
+	*len = 0;
+
+	while (nrf24l01_try_receive(handle->radio, frame) == ERR_CODE_SUCCESS)
+	{
+		uint32_t rx_time = handle->get_time_us();
+
+		if ((frame[NRF24L01_RELAY_OFS_LEN] == 0) ||
+		    (frame[NRF24L01_RELAY_OFS_LEN] > (handle->packet_len - NRF24L01_RELAY_HEADER_LEN)))
+		{
+			continue;
+		}
+
+		if (frame[NRF24L01_RELAY_OFS_DST] != handle->node_id)
+		{
+			nrf24l01_relay_forward(handle, rx_time);
+			continue;
+		}
+
+		uint8_t hops = frame[NRF24L01_RELAY_OFS_HOPS];
+		uint32_t latency = frame[NRF24L01_RELAY_OFS_LATENCY] | ((uint32_t)frame[NRF24L01_RELAY_OFS_LATENCY + 1] << 8);
+
+		handle->stats.num_delivered++;
+		handle->stats.sum_hops += hops;
+		handle->stats.sum_latency_us += latency * NRF24L01_RELAY_LATENCY_UNIT_US;
+		if (hops > handle->stats.max_hops)
+		{
+			handle->stats.max_hops = hops;
+		}
+
+		*src = frame[NRF24L01_RELAY_OFS_SRC];
+		*data = &frame[NRF24L01_RELAY_HEADER_LEN];
+		*len = frame[NRF24L01_RELAY_OFS_LEN];
+
+		break;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_relay_get_stats(nrf24l01_relay_handle_t handle, nrf24l01_relay_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*stats = handle->stats;
+
+	return ERR_CODE_SUCCESS;
+}
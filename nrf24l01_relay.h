@@ -0,0 +1,208 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_RELAY_H__
+#define __NRF24L01_RELAY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   Relay header length. Each frame carries destination, source, hop
+ * 			count, data length and accumulated relay latency in units of
+ * 			NRF24L01_RELAY_LATENCY_UNIT_US, packet_len - 6 bytes of data remain.
+ * 			Relay latency is the sum, over relay nodes, of the time from reading
+ * 			the frame out of RX FIFO to writing it into TX FIFO. Time waiting in
+ * 			RX FIFO, air time and retransmits of each hop are not included.
+ */
+#define NRF24L01_RELAY_HEADER_LEN 		6
+#define NRF24L01_RELAY_LATENCY_UNIT_US 	100
+#define NRF24L01_RELAY_NO_ROUTE 		0xFF
+
+/**
+ * @brief   Relay handle structure.
+ */
+typedef struct nrf24l01_relay* nrf24l01_relay_handle_t;
+
+/**
+ * @brief   Configuration structure.
+ *
+ * @note 	Address of a node is "base_addr" with the first byte replaced by its
+ * 			node id. The node receives on pipe 1.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint8_t 					node_id;			/*!< Own node id */
+	uint8_t 					base_addr[5];		/*!< Base address, addr_width bytes used */
+	uint8_t 					num_route;			/*!< Size of routing table */
+	uint8_t 					max_hops;			/*!< Frame is dropped after this number of hops */
+	uint32_t 					tx_timeout_ms;		/*!< Timeout of one frame transmission */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+} nrf24l01_relay_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_tx;				/*!< Frames originated */
+	uint32_t 					num_delivered;		/*!< Frames received for this node */
+	uint32_t 					num_forward;		/*!< Frames forwarded */
+	uint32_t 					num_no_route;		/*!< Frames dropped, no route */
+	uint32_t 					num_hop_limit;		/*!< Frames dropped, too many hops */
+	uint32_t 					num_tx_fail;		/*!< Frames not acknowledged by next hop */
+	uint32_t 					sum_hops;			/*!< Sum of relay hops of delivered frames */
+	uint8_t 					max_hops;			/*!< Maximum relay hops of delivered frames */
+	uint32_t 					sum_latency_us;		/*!< Sum of relay latency of delivered frames, see header */
+	uint32_t 					sum_forward_us;		/*!< Sum of time from RX FIFO read to end of transmission to next hop */
+	uint32_t 					max_forward_us;		/*!< Maximum time from RX FIFO read to end of transmission to next hop */
+} nrf24l01_relay_stats_t;
+
+/*
+ * @brief   Initialize relay layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_relay_handle_t nrf24l01_relay_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_set_config(nrf24l01_relay_handle_t handle, nrf24l01_relay_cfg_t config);
+
+/*
+ * @brief   Configure relay layer to run. The routing table is cleared and the
+ * 			radio is put in RX mode on the own address.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_config(nrf24l01_relay_handle_t handle);
+
+/*
+ * @brief   Add or replace the route to a destination.
+ *
+ * @param 	handle Handle structure.
+ * @param 	dst Destination node id.
+ * @param 	next_hop Neighbor node id frames to "dst" are sent to.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, routing table is full.
+ */
+err_code_t nrf24l01_relay_set_route(nrf24l01_relay_handle_t handle, uint8_t dst, uint8_t next_hop);
+
+/*
+ * @brief   Remove the route to a destination.
+ *
+ * @param 	handle Handle structure.
+ * @param 	dst Destination node id.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_del_route(nrf24l01_relay_handle_t handle, uint8_t dst);
+
+/*
+ * @brief   Set the next hop used when no route matches, usually toward the
+ * 			gateway.
+ *
+ * @param 	handle Handle structure.
+ * @param 	next_hop Neighbor node id, NRF24L01_RELAY_NO_ROUTE to drop.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_set_default_route(nrf24l01_relay_handle_t handle, uint8_t next_hop);
+
+/*
+ * @brief   Send data to a node through the routing table.
+ *
+ * @param 	handle Handle structure.
+ * @param 	dst Destination node id.
+ * @param 	data Data.
+ * @param 	len Data length, 1 to packet_len - NRF24L01_RELAY_HEADER_LEN.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_transmit(nrf24l01_relay_handle_t handle, uint8_t dst, uint8_t *data, uint8_t len);
+
+/*
+ * @brief   Drain RX FIFO. Frames for other nodes are forwarded to their next
+ * 			hop from the same buffer they are read into. Returns after the
+ * 			first frame for this node or when RX FIFO is empty.
+ *
+ * @param 	handle Handle structure.
+ * @param 	src Source node id of received data.
+ * @param 	data Received data, pointer into the internal frame buffer, valid
+ * 			until the next call of this function or "nrf24l01_relay_transmit",
+ * 			which both overwrite the frame buffer.
+ * @param 	len Data length, 0 if no data for this node.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_process(nrf24l01_relay_handle_t handle, uint8_t *src, uint8_t **data, uint8_t *len);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_relay_get_stats(nrf24l01_relay_handle_t handle, nrf24l01_relay_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_RELAY_H__ */
@@ -0,0 +1,402 @@
+#include "stdlib.h"
+#include "string.h"
+#include "nrf24l01_tdma.h"
+
+#define NRF24L01_TDMA_TYPE_BEACON 		0xB0
+
+/**
+ * @brief   Settling time from standby to TX or RX mode, Tstby2a.
+ */
+#define NRF24L01_TDMA_SETTLING_US 		130
+
+/**
+ * @brief   Preamble and packet control field on air, in bits.
+ */
+#define NRF24L01_TDMA_PREAMBLE_BITS 	8
+#define NRF24L01_TDMA_PCF_BITS 			9
+
+/**
+ * @brief   Long waits are done by 1 ms delay, the rest is busy waiting.
+ */
+#define NRF24L01_TDMA_BUSY_WAIT_US 		2000
+
+static const uint16_t nrf24l01_tdma_rate_kbps[] = {250, 1000, 2000};
+
+typedef struct nrf24l01_tdma {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	nrf24l01_tdma_role_t 		role;				/*!< Role */
+	uint8_t 					node_id;			/*!< Node id */
+	uint32_t 					slot_len_us;		/*!< Slot length */
+	uint8_t 					slot_cnt;			/*!< Slots per superframe */
+	uint16_t 					guard_us;			/*!< Margin added to both ends of a slot */
+	uint8_t 					max_beacon_age;		/*!< Superframes a node keeps sending without beacon */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					max_slot_cnt;		/*!< Slots fitting in one beacon */
+	uint8_t 					*frame;				/*!< Frame buffer, packet_len bytes */
+	uint8_t 					*slot;				/*!< Node id owning each slot */
+	uint16_t 					superframe;			/*!< Superframe number */
+	uint8_t 					synced;				/*!< At least one beacon is received */
+	uint8_t 					drift_valid;		/*!< Drift is estimated from two beacons */
+	uint32_t 					beacon_time;		/*!< Gateway time of last beacon */
+	uint32_t 					anchor_local;		/*!< Local time of last beacon */
+	uint32_t 					anchor_gateway;		/*!< Gateway time of last beacon at reception */
+	int32_t 					drift_ppm;			/*!< Gateway clock rate minus local clock rate */
+} nrf24l01_tdma_t;
+
+static uint32_t nrf24l01_tdma_airtime_us(nrf24l01_cfg_t *radio_cfg, uint8_t payload_len)
+{
+	uint32_t bits = NRF24L01_TDMA_PREAMBLE_BITS + NRF24L01_TDMA_PCF_BITS +
+	                8 * ((uint32_t)radio_cfg->addr_width + payload_len + radio_cfg->crc_len);
+
+	return (bits * 1000 + nrf24l01_tdma_rate_kbps[radio_cfg->data_rate] - 1) / nrf24l01_tdma_rate_kbps[radio_cfg->data_rate];
+}
+
+/**
+ * @brief   Worst case time from CE edge to end of the last retransmit.
+ */
+static uint32_t nrf24l01_tdma_tx_time_us(nrf24l01_tdma_handle_t handle)
+{
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	uint32_t airtime = nrf24l01_tdma_airtime_us(&radio_cfg, radio_cfg.packet_len);
+
+	return NRF24L01_TDMA_SETTLING_US + ((uint32_t)radio_cfg.retrans_cnt + 1) * (airtime + radio_cfg.retrans_delay);
+}
+
+static uint32_t nrf24l01_tdma_to_gateway_time(nrf24l01_tdma_handle_t handle, uint32_t local_us)
+{
+	uint32_t elapsed = local_us - handle->anchor_local;
+	int64_t correction = ((int64_t)elapsed * handle->drift_ppm) / 1000000;
+
+	return handle->anchor_gateway + elapsed + (int32_t)correction;
+}
+
+static void nrf24l01_tdma_wait_until(nrf24l01_tdma_handle_t handle, nrf24l01_func_delay delay, uint32_t local_us)
+{
+	int32_t remain;
+
+	while ((remain = (int32_t)(local_us - handle->get_time_us())) > 0)
+	{
+		if ((remain > NRF24L01_TDMA_BUSY_WAIT_US) && (delay != NULL))
+		{
+			delay(1);
+		}
+	}
+}
+
+nrf24l01_tdma_handle_t nrf24l01_tdma_init(void)
+{
+	nrf24l01_tdma_handle_t handle = calloc(1, sizeof(nrf24l01_tdma_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_tdma_set_config(nrf24l01_tdma_handle_t handle, nrf24l01_tdma_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->role = config.role;
+	handle->node_id = config.node_id;
+	handle->slot_len_us = config.slot_len_us;
+	handle->slot_cnt = config.slot_cnt;
+	handle->guard_us = config.guard_us;
+	handle->max_beacon_age = config.max_beacon_age;
+	handle->get_time_us = config.get_time_us;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_tdma_config(nrf24l01_tdma_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->get_time_us == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	if (radio_cfg.packet_len <= NRF24L01_TDMA_HEADER_LEN)
+	{
+		return ERR_CODE_FAIL;
+	}
+	handle->packet_len = radio_cfg.packet_len;
+	handle->max_slot_cnt = radio_cfg.packet_len - NRF24L01_TDMA_HEADER_LEN;
+
+	if (handle->role == NRF24L01_TDMA_ROLE_GATEWAY)
+	{
+		uint32_t min_slot_len;
+		nrf24l01_tdma_get_min_slot_len(handle, &min_slot_len);
+
+		if ((handle->slot_cnt == 0) || (handle->slot_cnt > handle->max_slot_cnt) ||
+		    (handle->slot_len_us < min_slot_len) || (handle->slot_len_us > NRF24L01_TDMA_MAX_SLOT_LEN_US))
+		{
+			return ERR_CODE_FAIL;
+		}
+	}
+
+	free(handle->frame);
+	free(handle->slot);
+
+	handle->frame = calloc(handle->packet_len, sizeof(uint8_t));
+	handle->slot = calloc(handle->max_slot_cnt, sizeof(uint8_t));
+	if ((handle->frame == NULL) || (handle->slot == NULL))
+	{
+		return ERR_CODE_FAIL;
+	}
+	memset(handle->slot, NRF24L01_TDMA_SLOT_FREE, handle->max_slot_cnt);
+
+	handle->superframe = 0;
+	handle->synced = 0;
+	handle->drift_valid = 0;
+	handle->drift_ppm = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_tdma_get_min_slot_len(nrf24l01_tdma_handle_t handle, uint32_t *slot_len_us)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (slot_len_us == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*slot_len_us = nrf24l01_tdma_tx_time_us(handle) + 2 * (uint32_t)handle->guard_us;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_tdma_set_slot(nrf24l01_tdma_handle_t handle, uint8_t slot, uint8_t node_id)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->role != NRF24L01_TDMA_ROLE_GATEWAY) || (slot >= handle->slot_cnt))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	handle->slot[slot] = node_id;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_tdma_send_beacon(nrf24l01_tdma_handle_t handle, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (handle->role != NRF24L01_TDMA_ROLE_GATEWAY)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	err_code_t err_ret;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	memset(handle->frame, 0, handle->packet_len);
+	memcpy(&handle->frame[NRF24L01_TDMA_HEADER_LEN], handle->slot, handle->slot_cnt);
+	handle->frame[0] = NRF24L01_TDMA_TYPE_BEACON;
+	handle->frame[1] = handle->superframe & 0xFF;
+	handle->frame[2] = (handle->superframe >> 8) & 0xFF;
+	handle->frame[7] = handle->slot_len_us & 0xFF;
+	handle->frame[8] = (handle->slot_len_us >> 8) & 0xFF;
+	handle->frame[9] = (handle->slot_len_us >> 16) & 0xFF;
+	handle->frame[10] = handle->slot_cnt;
+
+	/* Time reference is taken as late as possible before the payload is written */
+	handle->beacon_time = handle->get_time_us();
+	handle->frame[3] = handle->beacon_time & 0xFF;
+	handle->frame[4] = (handle->beacon_time >> 8) & 0xFF;
+	handle->frame[5] = (handle->beacon_time >> 16) & 0xFF;
+	handle->frame[6] = (handle->beacon_time >> 24) & 0xFF;
+
+	err_ret = nrf24l01_transmit_noack_pipelined(handle->radio, handle->frame, timeout_ms);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, timeout_ms);
+	}
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	handle->superframe++;
+
+	return err_ret;
+}
+
+err_code_t nrf24l01_tdma_process_beacon(nrf24l01_tdma_handle_t handle, uint8_t *rx_payload, uint32_t rx_time_us, uint8_t *is_beacon)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (rx_payload == NULL) || (is_beacon == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	*is_beacon = 0;
+
+	if ((handle->role != NRF24L01_TDMA_ROLE_NODE) || (rx_payload[0] != NRF24L01_TDMA_TYPE_BEACON))
+	{
+		return ERR_CODE_SUCCESS;
+	}
+
+	uint8_t slot_cnt = rx_payload[10];
+	uint32_t slot_len_us = rx_payload[7] | (rx_payload[8] << 8) | ((uint32_t)rx_payload[9] << 16);
+	if ((slot_cnt == 0) || (slot_cnt > handle->max_slot_cnt) || (slot_len_us == 0))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	*is_beacon = 1;
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	uint32_t beacon_time = rx_payload[3] | (rx_payload[4] << 8) | (rx_payload[5] << 16) | ((uint32_t)rx_payload[6] << 24);
+
+	/* Gateway time when the beacon is fully received */
+	uint32_t gateway_time = beacon_time + NRF24L01_TDMA_SETTLING_US + nrf24l01_tdma_airtime_us(&radio_cfg, radio_cfg.packet_len);
+
+	if (handle->synced)
+	{
+		int32_t local_dt = (int32_t)(rx_time_us - handle->anchor_local);
+		int32_t gateway_dt = (int32_t)(gateway_time - handle->anchor_gateway);
+
+		if (local_dt > 0)
+		{
+			int32_t drift_ppm = (int32_t)(((int64_t)(gateway_dt - local_dt) * 1000000) / local_dt);
+
+			/* First estimate is taken as is, then smoothed over 4 beacons */
+			if (handle->drift_valid)
+			{
+				handle->drift_ppm = (3 * handle->drift_ppm + drift_ppm) / 4;
+			}
+			else
+			{
+				handle->drift_ppm = drift_ppm;
+				handle->drift_valid = 1;
+			}
+		}
+	}
+
+	handle->anchor_local = rx_time_us;
+	handle->anchor_gateway = gateway_time;
+	handle->beacon_time = beacon_time;
+	handle->superframe = rx_payload[1] | (rx_payload[2] << 8);
+	handle->slot_len_us = slot_len_us;
+	handle->slot_cnt = slot_cnt;
+	memcpy(handle->slot, &rx_payload[NRF24L01_TDMA_HEADER_LEN], slot_cnt);
+	handle->synced = 1;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_tdma_transmit(nrf24l01_tdma_handle_t handle, uint8_t *tx_payload, uint32_t timeout_ms)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (tx_payload == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->role != NRF24L01_TDMA_ROLE_NODE) || !handle->synced)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+
+	uint32_t start_local = handle->get_time_us();
+	uint32_t now_gateway = nrf24l01_tdma_to_gateway_time(handle, start_local);
+	uint32_t since_beacon = now_gateway - handle->beacon_time;
+	uint32_t superframe_len = (uint32_t)handle->slot_len_us * (handle->slot_cnt + 1);
+	uint32_t superframe_idx = since_beacon / superframe_len;
+
+	if (superframe_idx > handle->max_beacon_age)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	/* Uncertainty grows with time since beacon, allow twice the estimated drift */
+	int32_t drift_ppm = (handle->drift_ppm < 0) ? -handle->drift_ppm : handle->drift_ppm;
+	uint32_t guard_us = handle->guard_us + (uint32_t)(((uint64_t)since_beacon * (2 * (uint32_t)drift_ppm + 1)) / 1000000);
+	uint32_t tx_time = nrf24l01_tdma_tx_time_us(handle);
+
+	/* Earliest own slot in current or next superframe with room for the packet */
+	uint8_t found = 0;
+	uint32_t tx_start = 0;
+
+	for (uint32_t sf = superframe_idx; (sf <= (superframe_idx + 1)) && !found; sf++)
+	{
+		for (uint8_t i = 0; i < handle->slot_cnt; i++)
+		{
+			if (handle->slot[i] != handle->node_id)
+			{
+				continue;
+			}
+
+			uint32_t slot_start = sf * superframe_len + (uint32_t)(i + 1) * handle->slot_len_us + guard_us;
+			uint32_t slot_end = sf * superframe_len + (uint32_t)(i + 2) * handle->slot_len_us - guard_us;
+			uint32_t begin = (slot_start > since_beacon) ? slot_start : since_beacon;
+
+			if ((begin + tx_time) <= slot_end)
+			{
+				tx_start = begin;
+				found = 1;
+				break;
+			}
+		}
+	}
+
+	if (!found)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint32_t wait_us = tx_start - since_beacon;
+	if (wait_us > ((uint64_t)timeout_ms * 1000))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_tdma_wait_until(handle, radio_cfg.delay, start_local + wait_us);
+
+	err_code_t err_ret;
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_TX);
+
+	err_ret = nrf24l01_transmit_pipelined(handle->radio, tx_payload, timeout_ms);
+	if (err_ret == ERR_CODE_SUCCESS)
+	{
+		err_ret = nrf24l01_wait_tx_complete(handle->radio, timeout_ms);
+	}
+
+	nrf24l01_set_transceiver_mode(handle->radio, NRF24L01_TRANSCEIVER_MODE_RX);
+
+	return err_ret;
+}
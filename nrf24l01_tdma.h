@@ -0,0 +1,190 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_TDMA_H__
+#define __NRF24L01_TDMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   A superframe starts with a beacon from the gateway and is followed
+ * 			by "slot_cnt" slots of "slot_len_us". Beacon carries superframe
+ * 			number, gateway time, 24-bit slot length, slot count and the node
+ * 			id owning each slot, so packet_len - 11 slots fit in one beacon.
+ */
+#define NRF24L01_TDMA_HEADER_LEN 		11
+#define NRF24L01_TDMA_MAX_SLOT_LEN_US 	0xFFFFFF
+#define NRF24L01_TDMA_SLOT_FREE 		0xFF
+
+/**
+ * @brief   TDMA handle structure.
+ */
+typedef struct nrf24l01_tdma* nrf24l01_tdma_handle_t;
+
+/**
+ * @brief   Role.
+ */
+typedef enum {
+	NRF24L01_TDMA_ROLE_GATEWAY = 0,				/*!< Transmit beacon, receive in slots */
+	NRF24L01_TDMA_ROLE_NODE						/*!< Follow beacon, transmit in own slots */
+} nrf24l01_tdma_role_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	nrf24l01_tdma_role_t 		role;				/*!< Role */
+	uint8_t 					node_id;			/*!< Node id, node only */
+	uint32_t 					slot_len_us;		/*!< Slot length, up to 16.7 s, gateway only */
+	uint8_t 					slot_cnt;			/*!< Slots per superframe, gateway only */
+	uint16_t 					guard_us;			/*!< Margin added to both ends of a slot */
+	uint8_t 					max_beacon_age;		/*!< Superframes a node keeps sending without beacon */
+	nrf24l01_func_get_time_us 	get_time_us;		/*!< Function get time in us */
+} nrf24l01_tdma_cfg_t;
+
+/*
+ * @brief   Initialize TDMA layer.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_tdma_handle_t nrf24l01_tdma_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_set_config(nrf24l01_tdma_handle_t handle, nrf24l01_tdma_cfg_t config);
+
+/*
+ * @brief   Configure TDMA layer to run.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_config(nrf24l01_tdma_handle_t handle);
+
+/*
+ * @brief   Get shortest slot length which fits one packet with all its
+ * 			retransmits: TX settling (130 us), time on air of the packet and
+ * 			ARC times (ARD + time on air), plus guard on both ends.
+ *
+ * @param 	handle Handle structure.
+ * @param 	slot_len_us Slot length in us.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_get_min_slot_len(nrf24l01_tdma_handle_t handle, uint32_t *slot_len_us);
+
+/*
+ * @brief   Assign slot to a node, gateway only. Takes effect from next beacon.
+ *
+ * @param 	handle Handle structure.
+ * @param 	slot Slot index.
+ * @param 	node_id Node id, NRF24L01_TDMA_SLOT_FREE to release the slot.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_set_slot(nrf24l01_tdma_handle_t handle, uint8_t slot, uint8_t node_id);
+
+/*
+ * @brief   Transmit beacon which starts a superframe, gateway only. Radio is
+ * 			left in RX mode to receive from nodes.
+ *
+ * @note 	Call exactly once per superframe, every slot_len_us * (slot_cnt + 1)
+ * 			us. Nodes place their slots from the last beacon assuming this
+ * 			period, a late or missing beacon makes them drift out of their
+ * 			slots, after "max_beacon_age" superframes they stop sending.
+ *
+ * @param 	handle Handle structure.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_send_beacon(nrf24l01_tdma_handle_t handle, uint32_t timeout_ms);
+
+/*
+ * @brief   Check whether received frame is a beacon and synchronize to it,
+ * 			node only. Offset and drift of the local clock to the gateway clock
+ * 			are updated.
+ *
+ * @param 	handle Handle structure.
+ * @param 	rx_payload Received frame, packet_len bytes.
+ * @param 	rx_time_us Local time when the frame was received, e.g. sampled
+ * 			on IRQ.
+ * @param 	is_beacon Frame is a beacon.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_tdma_process_beacon(nrf24l01_tdma_handle_t handle, uint8_t *rx_payload, uint32_t rx_time_us, uint8_t *is_beacon);
+
+/*
+ * @brief   Wait for next own slot and transmit data in it, node only. Radio
+ * 			is switched to TX mode for the slot and back to RX mode after.
+ *
+ * @note 	Function "delay" of the radio need to be assigned.
+ *
+ * @param 	handle Handle structure.
+ * @param 	tx_payload Transmit buffer.
+ * @param 	timeout_ms Timeout in ms.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, e.g. no own slot or beacon lost.
+ */
+err_code_t nrf24l01_tdma_transmit(nrf24l01_tdma_handle_t handle, uint8_t *tx_payload, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_TDMA_H__ */
@@ -0,0 +1,277 @@
+#include "stdlib.h"
+#include "string.h"
+#include "stdatomic.h"
+#include "nrf24l01_txq.h"
+
+/**
+ * @brief   Bounded multi-producer queue. Each cell has a sequence number which
+ * 			tells whether it is free for the producer at a position or filled
+ * 			for the consumer, so producers only race on "enqueue_pos".
+ */
+typedef struct {
+	_Atomic uint32_t 			enqueue_pos;		/*!< Next position claimed by a producer */
+	uint32_t 					dequeue_pos;		/*!< Next position read by the consumer */
+	_Atomic uint32_t 			*seq;				/*!< Sequence number of each cell */
+	uint8_t 					*buf;				/*!< Cells, queue_len * packet_len bytes */
+	_Atomic uint32_t 			num_queued;			/*!< Frames accepted */
+	_Atomic uint32_t 			num_full;			/*!< Frames rejected */
+} nrf24l01_txq_queue_t;
+
+typedef struct nrf24l01_txq {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					queue_len;			/*!< Queue length of each class */
+	uint8_t 					fifo_depth;			/*!< Frames kept in TX FIFO */
+	uint8_t 					packet_len;			/*!< Packet length of the radio */
+	uint8_t 					in_fifo;			/*!< Frames written to TX FIFO */
+	nrf24l01_txq_queue_t 		queue[NRF24L01_TXQ_PRIO_MAX];	/*!< Queue of each class */
+	uint32_t 					num_sent[NRF24L01_TXQ_PRIO_MAX];	/*!< Frames written to TX FIFO */
+	uint32_t 					num_fail;			/*!< MAX_RT */
+} nrf24l01_txq_t;
+
+static uint8_t *nrf24l01_txq_cell(nrf24l01_txq_handle_t handle, nrf24l01_txq_queue_t *queue, uint32_t pos)
+{
+	return &queue->buf[(pos & (handle->queue_len - 1)) * (uint32_t)handle->packet_len];
+}
+
+static uint8_t *nrf24l01_txq_peek(nrf24l01_txq_handle_t handle, nrf24l01_txq_queue_t *queue)
+{
+	uint32_t pos = queue->dequeue_pos;
+	uint32_t seq = atomic_load_explicit(&queue->seq[pos & (handle->queue_len - 1)], memory_order_acquire);
+
+	if ((int32_t)(seq - (pos + 1)) < 0)
+	{
+		return NULL;
+	}
+
+	return nrf24l01_txq_cell(handle, queue, pos);
+}
+
+static void nrf24l01_txq_pop(nrf24l01_txq_handle_t handle, nrf24l01_txq_queue_t *queue)
+{
+	uint32_t pos = queue->dequeue_pos;
+
+	queue->dequeue_pos = pos + 1;
+	atomic_store_explicit(&queue->seq[pos & (handle->queue_len - 1)], pos + handle->queue_len, memory_order_release);
+}
+
+nrf24l01_txq_handle_t nrf24l01_txq_init(void)
+{
+	nrf24l01_txq_handle_t handle = calloc(1, sizeof(nrf24l01_txq_t));
+	if (handle == NULL)
+	{
+		return NULL;
+	}
+
+	return handle;
+}
+
+err_code_t nrf24l01_txq_set_config(nrf24l01_txq_handle_t handle, nrf24l01_txq_cfg_t config)
+{
+	/* Check if handle structure is NULL */
+	if (handle == NULL)
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	handle->radio = config.radio;
+	handle->queue_len = config.queue_len;
+	handle->fifo_depth = config.fifo_depth;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_txq_config(nrf24l01_txq_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if ((handle->queue_len == 0) || ((handle->queue_len & (handle->queue_len - 1)) != 0) ||
+	    (handle->fifo_depth == 0) || (handle->fifo_depth > NRF24L01_TX_FIFO_DEPTH))
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_cfg_t radio_cfg;
+	nrf24l01_get_config(handle->radio, &radio_cfg);
+	handle->packet_len = radio_cfg.packet_len;
+
+	for (uint8_t prio = 0; prio < NRF24L01_TXQ_PRIO_MAX; prio++)
+	{
+		nrf24l01_txq_queue_t *queue = &handle->queue[prio];
+
+		free((void *)queue->seq);
+		free(queue->buf);
+
+		queue->seq = calloc(handle->queue_len, sizeof(_Atomic uint32_t));
+		queue->buf = calloc(handle->queue_len, handle->packet_len);
+		if ((queue->seq == NULL) || (queue->buf == NULL))
+		{
+			/* Leave all queues unconfigured */
+			for (prio = 0; prio < NRF24L01_TXQ_PRIO_MAX; prio++)
+			{
+				free((void *)handle->queue[prio].seq);
+				free(handle->queue[prio].buf);
+				handle->queue[prio].seq = NULL;
+				handle->queue[prio].buf = NULL;
+			}
+			return ERR_CODE_FAIL;
+		}
+
+		for (uint32_t i = 0; i < handle->queue_len; i++)
+		{
+			atomic_init(&queue->seq[i], i);
+		}
+		atomic_init(&queue->enqueue_pos, 0);
+		atomic_init(&queue->num_queued, 0);
+		atomic_init(&queue->num_full, 0);
+		queue->dequeue_pos = 0;
+
+		handle->num_sent[prio] = 0;
+	}
+
+	handle->in_fifo = 0;
+	handle->num_fail = 0;
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_txq_transmit(nrf24l01_txq_handle_t handle, uint8_t *tx_payload, nrf24l01_txq_prio_t prio)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (tx_payload == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	if (prio >= NRF24L01_TXQ_PRIO_MAX)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	nrf24l01_txq_queue_t *queue = &handle->queue[prio];
+
+	/* Not configured */
+	if (queue->seq == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint32_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+
+	while (1)
+	{
+		uint32_t seq = atomic_load_explicit(&queue->seq[pos & (handle->queue_len - 1)], memory_order_acquire);
+		int32_t diff = (int32_t)(seq - pos);
+
+		if (diff == 0)
+		{
+			/* Cell is free at this position, claim it */
+			if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+			                                          memory_order_relaxed, memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			atomic_fetch_add_explicit(&queue->num_full, 1, memory_order_relaxed);
+			return ERR_CODE_FAIL;
+		}
+		else
+		{
+			pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+		}
+	}
+
+	memcpy(nrf24l01_txq_cell(handle, queue, pos), tx_payload, handle->packet_len);
+	atomic_store_explicit(&queue->seq[pos & (handle->queue_len - 1)], pos + 1, memory_order_release);
+	atomic_fetch_add_explicit(&queue->num_queued, 1, memory_order_relaxed);
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_txq_process(nrf24l01_txq_handle_t handle)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (handle->radio == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	/* Not configured, queues are allocated all together */
+	if (handle->queue[0].seq == NULL)
+	{
+		return ERR_CODE_FAIL;
+	}
+
+	uint8_t fifo_status;
+	uint8_t num_done;
+
+	if (nrf24l01_get_tx_done(handle->radio, handle->in_fifo, &num_done) != ERR_CODE_SUCCESS)
+	{
+		handle->num_fail++;
+		handle->in_fifo = 0;
+	}
+	else
+	{
+		handle->in_fifo -= num_done;
+	}
+
+	while (handle->in_fifo < handle->fifo_depth)
+	{
+		nrf24l01_txq_queue_t *queue = NULL;
+		uint8_t *frame = NULL;
+		uint8_t prio;
+
+		for (prio = 0; prio < NRF24L01_TXQ_PRIO_MAX; prio++)
+		{
+			frame = nrf24l01_txq_peek(handle, &handle->queue[prio]);
+			if (frame != NULL)
+			{
+				queue = &handle->queue[prio];
+				break;
+			}
+		}
+
+		if (queue == NULL)
+		{
+			break;
+		}
+
+		nrf24l01_get_fifo_status(handle->radio, &fifo_status);
+		if (fifo_status & NRF24L01_FIFO_STATUS_TX_FULL)
+		{
+			break;
+		}
+
+		nrf24l01_transmit(handle->radio, frame);
+		nrf24l01_txq_pop(handle, queue);
+
+		handle->num_sent[prio]++;
+		handle->in_fifo++;
+	}
+
+	return ERR_CODE_SUCCESS;
+}
+
+err_code_t nrf24l01_txq_get_stats(nrf24l01_txq_handle_t handle, nrf24l01_txq_stats_t *stats)
+{
+	/* Check if handle structure is NULL */
+	if ((handle == NULL) || (stats == NULL))
+	{
+		return ERR_CODE_NULL_PTR;
+	}
+
+	for (uint8_t prio = 0; prio < NRF24L01_TXQ_PRIO_MAX; prio++)
+	{
+		stats->num_queued[prio] = atomic_load_explicit(&handle->queue[prio].num_queued, memory_order_relaxed);
+		stats->num_full[prio] = atomic_load_explicit(&handle->queue[prio].num_full, memory_order_relaxed);
+		stats->num_sent[prio] = handle->num_sent[prio];
+	}
+	stats->num_fail = handle->num_fail;
+
+	return ERR_CODE_SUCCESS;
+}
@@ -0,0 +1,151 @@
+// MIT License
+
+// Copyright (c) 2024 phonght32
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef __NRF24L01_TXQ_H__
+#define __NRF24L01_TXQ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "err_code.h"
+#include "nrf24l01.h"
+
+/**
+ * @brief   TX scheduler handle structure.
+ */
+typedef struct nrf24l01_txq* nrf24l01_txq_handle_t;
+
+/**
+ * @brief   Priority class. Lower value is served first.
+ */
+typedef enum {
+	NRF24L01_TXQ_PRIO_CONTROL = 0,				/*!< Control traffic */
+	NRF24L01_TXQ_PRIO_NORMAL,					/*!< Normal traffic */
+	NRF24L01_TXQ_PRIO_BULK,						/*!< Bulk data */
+	NRF24L01_TXQ_PRIO_MAX
+} nrf24l01_txq_prio_t;
+
+/**
+ * @brief   Configuration structure.
+ */
+typedef struct {
+	nrf24l01_handle_t 			radio;				/*!< Radio handle */
+	uint16_t 					queue_len;			/*!< Queue length of each class, power of 2 */
+	uint8_t 					fifo_depth;			/*!< Frames kept in TX FIFO, 1 to 3 */
+} nrf24l01_txq_cfg_t;
+
+/**
+ * @brief   Statistics structure.
+ */
+typedef struct {
+	uint32_t 					num_queued[NRF24L01_TXQ_PRIO_MAX];	/*!< Frames accepted */
+	uint32_t 					num_full[NRF24L01_TXQ_PRIO_MAX];	/*!< Frames rejected, queue full */
+	uint32_t 					num_sent[NRF24L01_TXQ_PRIO_MAX];	/*!< Frames written to TX FIFO */
+	uint32_t 					num_fail;			/*!< MAX_RT, frames in TX FIFO are dropped */
+} nrf24l01_txq_stats_t;
+
+/*
+ * @brief   Initialize TX scheduler.
+ *
+ * @note    This function must be called first.
+ *
+ * @param   None.
+ *
+ * @return
+ *      - Handle structure: Success.
+ *      - Others:           Fail.
+ */
+nrf24l01_txq_handle_t nrf24l01_txq_init(void);
+
+/*
+ * @brief   Set configuration parameters.
+ *
+ * @param 	handle Handle structure.
+ * @param   config Configuration structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_txq_set_config(nrf24l01_txq_handle_t handle, nrf24l01_txq_cfg_t config);
+
+/*
+ * @brief   Configure TX scheduler to run. Queues of all classes are allocated
+ * 			here.
+ *
+ * @note 	Radio must be configured by "nrf24l01_config" before.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_txq_config(nrf24l01_txq_handle_t handle);
+
+/*
+ * @brief   Queue one packet. Lock-free, may be called from several threads at
+ * 			the same time.
+ *
+ * @param 	handle Handle structure.
+ * @param 	tx_payload Transmit buffer, packet_len bytes.
+ * @param 	prio Priority class.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail, queue of the class is full or not configured.
+ */
+err_code_t nrf24l01_txq_transmit(nrf24l01_txq_handle_t handle, uint8_t *tx_payload, nrf24l01_txq_prio_t prio);
+
+/*
+ * @brief   Feed TX FIFO from the head of the highest priority non-empty queue.
+ * 			At most "fifo_depth" frames are in TX FIFO, so a control frame waits
+ * 			for at most that many frames already handed to the radio.
+ *
+ * @note 	Only one thread may call this function.
+ *
+ * @param 	handle Handle structure.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_txq_process(nrf24l01_txq_handle_t handle);
+
+/*
+ * @brief   Get statistics.
+ *
+ * @param 	handle Handle structure.
+ * @param 	stats Statistics.
+ *
+ * @return
+ *      - ERR_CODE_SUCCESS: Success.
+ *      - Others:           Fail.
+ */
+err_code_t nrf24l01_txq_get_stats(nrf24l01_txq_handle_t handle, nrf24l01_txq_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_TXQ_H__ */